@@ -29,7 +29,7 @@ void Photon::init() {
   network.parse = &parse;
   network.init();
   logs("Initialized Network");
-  gui.init(gpu, parse.arena, network);
+  gui.init(gpu, parse, network);
   logs("Initialized GUI");
 }
 
@@ -102,7 +102,7 @@ static BpsExtrema ComputeBpsExtrema(const AppState& state) {
 }
 
 static bool FormatBpsFaultDetail(const AppState& state, char* buffer, size_t bufferSize) {
-  const uint8_t bpsFaultCode = (uint8_t)state.get("BPS_Fault");
+  const uint8_t bpsFaultCode = (uint8_t)state.get(Sig::BPS_Fault);
   if (!buffer || bufferSize == 0 || bpsFaultCode == 0) {
     return false;
   }
@@ -188,8 +188,8 @@ struct ActiveFaultInfo {
 };
 
 static bool GetActiveFault(const AppState& state, ActiveFaultInfo& out) {
-  const uint8_t bpsFaultCode = (uint8_t)state.get("BPS_Fault");
-  const uint8_t vcuFaultCode = (uint8_t)state.get("VCU_Fault");
+  const uint8_t bpsFaultCode = (uint8_t)state.get(Sig::BPS_Fault);
+  const uint8_t vcuFaultCode = (uint8_t)state.get(Sig::VCU_Fault);
   if (bpsFaultCode != 0) {
     out.label = "BPS Fault";
     out.detail = BpsFaultName(bpsFaultCode);
@@ -335,7 +335,7 @@ static void RenderBatteryPanel(const AppState& state, const ImVec2& size) {
     {
       char currentLabel[16];
       snprintf(currentLabel, sizeof(currentLabel), "%.0fA",
-               std::abs(state.get("Main_Battery_Current")));
+               std::abs(state.get(Sig::Main_Battery_Current)));
       ImGuiIO& io = ImGui::GetIO();
       ImFont* medFont = (io.Fonts->Fonts.Size > 2) ? io.Fonts->Fonts[2] : nullptr;
       float fs = 28.0f;
@@ -427,11 +427,12 @@ static void RenderBatteryPanel(const AppState& state, const ImVec2& size) {
       ImGui::PopStyleColor();
     };
 
-    drawBatteryRow("M", (float)state.get("BPS_SoC"), (float)state.get("Main_Battery_Voltage"));
+    drawBatteryRow("M", (float)state.get(Sig::BPS_SoC),
+                   (float)state.get(Sig::Main_Battery_Voltage));
     widgets::Space(6);
-    drawBatteryRow("AU", (float)state.get("Supplemental_Battery_SOC"),
-                   (float)state.get("Supplemental_Battery_Voltage"),
-                   (float)(state.get("Supplemental_Battery_Current") * 0.001));
+    drawBatteryRow("AU", (float)state.get(Sig::Supplemental_Battery_SOC),
+                   (float)state.get(Sig::Supplemental_Battery_Voltage),
+                   (float)(state.get(Sig::Supplemental_Battery_Current) * 0.001));
 
     widgets::Space(12);
 
@@ -450,9 +451,9 @@ static void RenderBatteryPanel(const AppState& state, const ImVec2& size) {
       char hsTxt[24];
       char vTxt[24];
       char aTxt[24];
-      snprintf(hsTxt, sizeof(hsTxt), "%.0fC", state.get("MC_HeatsinkTemp"));
-      snprintf(vTxt, sizeof(vTxt), "%.0fV", state.get("MC_BusVoltage"));
-      snprintf(aTxt, sizeof(aTxt), "%.0fA", std::abs(state.get("MC_BusCurrent")));
+      snprintf(hsTxt, sizeof(hsTxt), "%.0fC", state.get(Sig::MC_HeatsinkTemp));
+      snprintf(vTxt, sizeof(vTxt), "%.0fV", state.get(Sig::MC_BusVoltage));
+      snprintf(aTxt, sizeof(aTxt), "%.0fA", std::abs(state.get(Sig::MC_BusCurrent)));
 
       ImGui::SameLine(colStart);
       ImGui::PushStyleColor(ImGuiCol_Text, Colors::MutedForeground());
@@ -507,7 +508,7 @@ static void RenderBatteryPanel(const AppState& state, const ImVec2& size) {
       widgets::Space(10);
     }
 
-    const float mainBatteryAvgTemp = (float)state.get("Main_Battery_Avg_Temperature");
+    const float mainBatteryAvgTemp = (float)state.get(Sig::Main_Battery_Avg_Temperature);
     if (mainBatteryAvgTemp > 0.0f) {
       ImGui::PushStyleColor(ImGuiCol_Text, Colors::Warning());
       ImGui::Text("BPS AVG: %.1fC", mainBatteryAvgTemp);
@@ -525,7 +526,7 @@ static void RenderBatteryPanel(const AppState& state, const ImVec2& size) {
       }
     }
 
-    if ((uint8_t)state.get("BPS_Fault") != 0) {
+    if ((uint8_t)state.get(Sig::BPS_Fault) != 0) {
       char detailTxt[96];
       const bool hasDetail = FormatBpsFaultDetail(state, detailTxt, sizeof(detailTxt));
       ImGui::PushStyleColor(ImGuiCol_Text, Colors::Destructive());
@@ -587,16 +588,16 @@ static void RenderButtonGrid(AppState& state, const ImVec2& size) {
       bool* statePtr;
     };
 
-    bool hvPositive = state.getBool("HV_Plus_Contactor_State");
-    bool hvNegative = state.getBool("HV_Minus_Contactor_State");
-    bool arrayPrecharge = state.getBool("Array_Precharge_Contactor_State");
-    bool arrayContactor = state.getBool("Array_Contactor_State");
-    bool motorPrecharge = state.getBool("Motor_Precharge_Contactor_State");
-    bool motorContactor = state.getBool("Motor_Contactor_State");
+    bool hvPositive = state.getBool(Sig::HV_Plus_Contactor_State);
+    bool hvNegative = state.getBool(Sig::HV_Minus_Contactor_State);
+    bool arrayPrecharge = state.getBool(Sig::Array_Precharge_Contactor_State);
+    bool arrayContactor = state.getBool(Sig::Array_Contactor_State);
+    bool motorPrecharge = state.getBool(Sig::Motor_Precharge_Contactor_State);
+    bool motorContactor = state.getBool(Sig::Motor_Contactor_State);
     // Ignition_Off == 0 means LV is enabled; default to disabled if absent.
-    bool lvEnabled = state.signals.count("Ignition_Off") && state.get("Ignition_Off") == 0.0;
-    bool arrayEnabled = state.getBool("Ignition_Array");
-    bool motorEnabled = state.getBool("Ignition_Motor");
+    bool lvEnabled = state.has(Sig::Ignition_Off) && state.get(Sig::Ignition_Off) == 0.0;
+    bool arrayEnabled = state.getBool(Sig::Ignition_Array);
+    bool motorEnabled = state.getBool(Sig::Ignition_Motor);
 
     BtnDef contactors[3][2] = {
         {{"HV+", &hvPositive}, {"HV-", &hvNegative}},
@@ -806,7 +807,7 @@ static void RenderSpeedGauge(AppState& state, const ImVec2& size) {
       // Cruise Control
       {
         ImVec4 ccCol =
-            state.getBool("Cruise_Enable") ? Colors::Warning() : Colors::MutedForeground();
+            state.getBool(Sig::Cruise_Enable) ? Colors::Warning() : Colors::MutedForeground();
         icons::DrawCruiseControl(dl, ImVec2(cX - iconSpacing, iconY), iconSize, ColorToU32(ccCol));
       }
       // Brake
@@ -817,7 +818,7 @@ static void RenderSpeedGauge(AppState& state, const ImVec2& size) {
       // Regen
       {
         ImVec4 rgCol =
-            state.getBool("Regen_Enable") ? Colors::Success() : Colors::MutedForeground();
+            state.getBool(Sig::Regen_Enable) ? Colors::Success() : Colors::MutedForeground();
         icons::DrawRegen(dl, ImVec2(cX + iconSpacing, iconY), iconSize, ColorToU32(rgCol));
       }
       // Right Turn Signal
@@ -879,7 +880,7 @@ static void RenderSpeedGauge(AppState& state, const ImVec2& size) {
         dl->AddRectFilled(pPos, ImVec2(pPos.x + pbW, pPos.y + pbH), ColorToU32(Colors::Muted()),
                           pbH * 0.5f);
 
-        float pct = std::clamp((float)state.get("AccelPedal_Main_Pos") / 100.0f, 0.0f, 1.0f);
+        float pct = std::clamp((float)state.get(Sig::AccelPedal_Main_Pos) / 100.0f, 0.0f, 1.0f);
         float fillW = pbW * pct;
         if (fillW > 2.0f) {
           ImDrawFlags fillFlags = ImDrawFlags_RoundCornersLeft;
@@ -889,13 +890,14 @@ static void RenderSpeedGauge(AppState& state, const ImVec2& size) {
         }
         // break pressure 1: front
         // break pressure 2: rear
-        const float brakePressure1 = (float)state.get("Brake_Pressure_1");
-        const float brakePressure2 = (float)state.get("Brake_Pressure_2");
+        const float brakePressure1 = (float)state.get(Sig::Brake_Pressure_1);
+        const float brakePressure2 = (float)state.get(Sig::Brake_Pressure_2);
         char pressureTxt[48];
         snprintf(pressureTxt, sizeof(pressureTxt), "FRONT %.0f   REAR %.0f",
                  std::max(0.0f, brakePressure1), std::max(0.0f, brakePressure2));
         ImVec4 pressureCol =
-            (state.getBool("Brake_Pressure_1_Fault") || state.getBool("Brake_Pressure_2_Fault"))
+            (state.getBool(Sig::Brake_Pressure_1_Fault) ||
+             state.getBool(Sig::Brake_Pressure_2_Fault))
                 ? Colors::Warning()
                 : ((std::max(brakePressure1, brakePressure2) > 25.0f) ? Colors::Destructive()
                                                                       : Colors::MutedForeground());
@@ -1096,18 +1098,19 @@ static void RenderDebugScreen(AppState& liveState) {
   widgets::Space(2);
 
   // LWS Standard (Steering)
-  const bool steeringSensorOK = state.signals.count("LWS_Fault") && state.get("LWS_Fault") == 0.0;
+  const bool steeringSensorOK = state.has(Sig::LWS_Fault) && state.get(Sig::LWS_Fault) == 0.0;
   ImGui::TextColored(ImVec4(0.8f, 0.6f, 1.0f, 1.0f), "STEERING SENSOR (LWS)");
-  ImGui::Text(" Angle: %.1f deg  %s", state.get("LWS_Angle"), steeringSensorOK ? "OK" : "FAULT");
+  ImGui::Text(" Angle: %.1f deg  %s", state.get(Sig::LWS_Angle), steeringSensorOK ? "OK" : "FAULT");
   widgets::Space(4);
 
   // Driver Inputs
   ImGui::TextColored(ImVec4(0.7f, 0.9f, 0.7f, 1.0f), "DRIVER INPUTS");
   ImGui::Text(
       " Horn:%s Hazard:%s PTT:%s Cruise Set:%s Regen Act:%s",
-      state.getBool("Horn_Pressed") ? "ON" : "-", state.getBool("Hazard_Pressed") ? "ON" : "-",
-      state.getBool("PushToTalk_Pressed") ? "ON" : "-", state.getBool("Cruise_Set") ? "ON" : "-",
-      state.getBool("Regen_Activate") ? "ON" : "-");
+      state.getBool(Sig::Horn_Pressed) ? "ON" : "-",
+      state.getBool(Sig::Hazard_Pressed) ? "ON" : "-",
+      state.getBool(Sig::PushToTalk_Pressed) ? "ON" : "-",
+      state.getBool(Sig::Cruise_Set) ? "ON" : "-", state.getBool(Sig::Regen_Activate) ? "ON" : "-");
   ImGui::Text(" Gear: %s  Turn: %s", GearToString(state.gear),
               state.turnSignal == TurnSignal::Left    ? "L"
               : state.turnSignal == TurnSignal::Right ? "R"
@@ -1117,36 +1120,36 @@ static void RenderDebugScreen(AppState& liveState) {
   // Accel/Brake Pedals
   ImGui::TextColored(ImVec4(0.8f, 0.6f, 1.0f, 1.0f), "ACCEL / BRAKE PEDALS");
   ImGui::Text(" Accel: Total %.0f%%  Main %d%% Red %d%% V:%.2f/%.2f",
-              state.get("AccelPedal_Main_Pos"), (uint8_t)state.get("AccelPedal_Main_Pos"),
-              (uint8_t)state.get("AccelPedal_Redundant_Pos"), state.get("Accel_Pos_Voltage_Main"),
-              state.get("Accel_Pos_Voltage_Redundant"));
-  ImGui::Text("        Faults: Main:%s Red:%s", flt(state.getBool("AccelPedal_Main_Fault")),
-              flt(state.getBool("AccelPedal_Redundant_Fault")));
+              state.get(Sig::AccelPedal_Main_Pos), (uint8_t)state.get(Sig::AccelPedal_Main_Pos),
+              (uint8_t)state.get(Sig::AccelPedal_Redundant_Pos),
+              state.get(Sig::Accel_Pos_Voltage_Main), state.get(Sig::Accel_Pos_Voltage_Redundant));
+  ImGui::Text("        Faults: Main:%s Red:%s", flt(state.getBool(Sig::AccelPedal_Main_Fault)),
+              flt(state.getBool(Sig::AccelPedal_Redundant_Fault)));
   ImGui::Text(" Brake: Engaged:%s  Main %d%% Red %d%% V:%.2f/%.2f",
-              state.brakeEngaged ? "YES" : "NO", (uint8_t)state.get("BrakePedal_Main_Pos"),
-              (uint8_t)state.get("BrakePedal_Redundant_Pos"), state.get("Brake_Pos_Voltage_Main"),
-              state.get("Brake_Pos_Voltage_Redundant"));
-  ImGui::Text("        Faults: Main:%s Red:%s", flt(state.getBool("BrakePedal_Main_Fault")),
-              flt(state.getBool("BrakePedal_Redundant_Fault")));
-  ImGui::Text(" Pressure: %.0f / %.0f psi (%s/%s)", state.get("Brake_Pressure_1"),
-              state.get("Brake_Pressure_2"), flt(state.getBool("Brake_Pressure_1_Fault")),
-              flt(state.getBool("Brake_Pressure_2_Fault")));
+              state.brakeEngaged ? "YES" : "NO", (uint8_t)state.get(Sig::BrakePedal_Main_Pos),
+              (uint8_t)state.get(Sig::BrakePedal_Redundant_Pos),
+              state.get(Sig::Brake_Pos_Voltage_Main), state.get(Sig::Brake_Pos_Voltage_Redundant));
+  ImGui::Text("        Faults: Main:%s Red:%s", flt(state.getBool(Sig::BrakePedal_Main_Fault)),
+              flt(state.getBool(Sig::BrakePedal_Redundant_Fault)));
+  ImGui::Text(" Pressure: %.0f / %.0f psi (%s/%s)", state.get(Sig::Brake_Pressure_1),
+              state.get(Sig::Brake_Pressure_2), flt(state.getBool(Sig::Brake_Pressure_1_Fault)),
+              flt(state.getBool(Sig::Brake_Pressure_2_Fault)));
   widgets::Space(4);
 
   // Hardware Switched Contactors / Ignitions
   ImGui::TextColored(ImVec4(0.4f, 1.0f, 0.4f, 1.0f), "CONTACTORS / IGNITION SWITCHES");
   ImGui::Text(" HV+:%s -:%s ArrP:%s Arr:%s MtrP:%s Mtr:%s",
-              state.getBool("HV_Plus_Contactor_State") ? "C" : "o",
-              state.getBool("HV_Minus_Contactor_State") ? "C" : "o",
-              state.getBool("Array_Precharge_Contactor_State") ? "C" : "o",
-              state.getBool("Array_Contactor_State") ? "C" : "o",
-              state.getBool("Motor_Precharge_Contactor_State") ? "C" : "o",
-              state.getBool("Motor_Contactor_State") ? "C" : "o");
+              state.getBool(Sig::HV_Plus_Contactor_State) ? "C" : "o",
+              state.getBool(Sig::HV_Minus_Contactor_State) ? "C" : "o",
+              state.getBool(Sig::Array_Precharge_Contactor_State) ? "C" : "o",
+              state.getBool(Sig::Array_Contactor_State) ? "C" : "o",
+              state.getBool(Sig::Motor_Precharge_Contactor_State) ? "C" : "o",
+              state.getBool(Sig::Motor_Contactor_State) ? "C" : "o");
   ImGui::Text(
       " Ignition: LV:%s  Array:%s  Motor:%s",
-      (state.signals.count("Ignition_Off") && state.get("Ignition_Off") == 0.0) ? "ON" : "off",
-      state.getBool("Ignition_Array") ? "ON" : "off",
-      state.getBool("Ignition_Motor") ? "ON" : "off");
+      (state.has(Sig::Ignition_Off) && state.get(Sig::Ignition_Off) == 0.0) ? "ON" : "off",
+      state.getBool(Sig::Ignition_Array) ? "ON" : "off",
+      state.getBool(Sig::Ignition_Motor) ? "ON" : "off");
   widgets::Space(4);
 
   ImGui::TextColored(Colors::Destructive(), "FAULTS");
@@ -1172,21 +1175,21 @@ static void RenderDebugScreen(AppState& liveState) {
   widgets::Space(2);
 
   // Motor Controller Outputs
-  const bool limitMotorCurrent = state.getBool("MC_LIMIT_MotorCurrent");
-  const bool limitVelocity = state.getBool("MC_LIMIT_Velocity");
-  const bool limitBusCurrent = state.getBool("MC_LIMIT_BusCurrent");
-  const bool limitBusVoltageUpper = state.getBool("MC_LIMIT_BusVoltageUpper");
-  const bool limitBusVoltageLower = state.getBool("MC_LIMIT_BusVoltageLower");
-  const bool limitIpmOrMotorTemp = state.getBool("MC_LIMIT_MotorTemp");
-  const bool limitOutputVoltage = state.getBool("MC_LIMIT_OutputVoltagePWM");
+  const bool limitMotorCurrent = state.getBool(Sig::MC_LIMIT_MotorCurrent);
+  const bool limitVelocity = state.getBool(Sig::MC_LIMIT_Velocity);
+  const bool limitBusCurrent = state.getBool(Sig::MC_LIMIT_BusCurrent);
+  const bool limitBusVoltageUpper = state.getBool(Sig::MC_LIMIT_BusVoltageUpper);
+  const bool limitBusVoltageLower = state.getBool(Sig::MC_LIMIT_BusVoltageLower);
+  const bool limitIpmOrMotorTemp = state.getBool(Sig::MC_LIMIT_MotorTemp);
+  const bool limitOutputVoltage = state.getBool(Sig::MC_LIMIT_OutputVoltagePWM);
   ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.2f, 1.0f), "MOTOR CONTROLLER (MoCo)");
-  ImGui::Text(" Vel: %d mph  Bus: %.1fV %.1fA", state.speed, state.get("MC_BusVoltage"),
-              state.get("MC_BusCurrent"));
+  ImGui::Text(" Vel: %d mph  Bus: %.1fV %.1fA", state.speed, state.get(Sig::MC_BusVoltage),
+              state.get(Sig::MC_BusCurrent));
   ImGui::Text(" Phase: %.1fA (B) %.1fA (C)  BEMF: %.1fV (Q) %.1fV (D)",
-              state.get("MC_PhaseCurrentB"), state.get("MC_PhaseCurrentC"), state.get("MC_BEMFq"),
-              state.get("MC_BEMFd"));
-  ImGui::Text(" Temp: Heatsink %.1fC  Precharge Motor: %.1fV", state.get("MC_HeatsinkTemp"),
-              state.get("VCU_Precharge_Motor_Voltage"));
+              state.get(Sig::MC_PhaseCurrentB), state.get(Sig::MC_PhaseCurrentC),
+              state.get(Sig::MC_BEMFq), state.get(Sig::MC_BEMFd));
+  ImGui::Text(" Temp: Heatsink %.1fC  Precharge Motor: %.1fV", state.get(Sig::MC_HeatsinkTemp),
+              state.get(Sig::VCU_Precharge_Motor_Voltage));
   ImGui::TextColored(
       Colors::Warning(), " Limits Active: %s%s%s%s%s%s%s%s",
       limitMotorCurrent ? "MotorCurrent " : "", limitVelocity ? "Velocity " : "",
@@ -1200,71 +1203,74 @@ static void RenderDebugScreen(AppState& liveState) {
   widgets::Space(4);
 
   // VCU Status & Precharge msg
-  const uint8_t vcuFaultCode = (uint8_t)state.get("VCU_Fault");
+  const uint8_t vcuFaultCode = (uint8_t)state.get(Sig::VCU_Fault);
   const bool vcuPedalsOK =
-      state.signals.count("VCU_Pedals_Watchdog") && state.get("VCU_Pedals_Watchdog") == 0.0;
-  const bool vcuDriverInputOK = state.signals.count("VCU_Driver_Input_Watchdog") &&
-                                state.get("VCU_Driver_Input_Watchdog") == 0.0;
+      state.has(Sig::VCU_Pedals_Watchdog) && state.get(Sig::VCU_Pedals_Watchdog) == 0.0;
+  const bool vcuDriverInputOK = state.has(Sig::VCU_Driver_Input_Watchdog) &&
+                                state.get(Sig::VCU_Driver_Input_Watchdog) == 0.0;
   ImVec4 vcuFCol = vcuFaultCode != 0 ? Colors::Destructive() : ImVec4(0.4f, 1.0f, 0.4f, 1.0f);
   ImGui::TextColored(ImVec4(0.6f, 0.8f, 1.0f, 1.0f), "VCU STATUS");
   ImGui::TextColored(vcuFCol, " Fault: %d (%s)  FSM State: %d", vcuFaultCode,
-                     VcuFaultName(vcuFaultCode), (uint8_t)state.get("VCU_FSM_State"));
-  ImGui::Text(" Motor Ready:%s Pedals:%s Driver Input:%s", state.getBool("Motor_Ready") ? "Y" : "N",
+                     VcuFaultName(vcuFaultCode), (uint8_t)state.get(Sig::VCU_FSM_State));
+  ImGui::Text(" Motor Ready:%s Pedals:%s Driver Input:%s",
+              state.getBool(Sig::Motor_Ready) ? "Y" : "N",
               vcuPedalsOK ? "OK" : "NO", vcuDriverInputOK ? "OK" : "NO");
-  ImGui::Text(" Regen:%s (Active:%s)", state.getBool("VCU_Regen_OK") ? "OK" : "NO",
-              state.getBool("VCU_Regen_Active") ? "Y" : "N");
+  ImGui::Text(" Regen:%s (Active:%s)", state.getBool(Sig::VCU_Regen_OK) ? "OK" : "NO",
+              state.getBool(Sig::VCU_Regen_Active) ? "Y" : "N");
   widgets::Space(4);
 
   // MPPT Solar
-  float mpptVin = (float)state.get("MPPT_Input_Voltage");
-  float mpptIin = (float)state.get("MPPT_Input_Current");
-  float mpptVout = (float)state.get("MPPT_Output_Voltage");
-  float mpptIout = (float)state.get("MPPT_Output_Current");
+  float mpptVin = (float)state.get(Sig::MPPT_Input_Voltage);
+  float mpptIin = (float)state.get(Sig::MPPT_Input_Current);
+  float mpptVout = (float)state.get(Sig::MPPT_Output_Voltage);
+  float mpptIout = (float)state.get(Sig::MPPT_Output_Current);
   float mpptPIn = mpptVin * mpptIin;
   float mpptPOut = mpptVout * mpptIout;
   ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.3f, 1.0f), "MPPT SOLAR");
   ImGui::Text(" In: %.1fV %.2fA (%.0fW)  Out: %.1fV %.2fA (%.0fW)", mpptVin, mpptIin, mpptPIn,
               mpptVout, mpptIout, mpptPOut);
   ImGui::Text(" Heatsink: %.0fC  Ambient: %.0fC  Fault:%d  Mode:%d",
-              state.get("MPPT_HeatsinkTemperature"), state.get("MPPT_AmbientTemperature"),
-              (uint8_t)state.get("MPPT_Fault"), (uint8_t)state.get("MPPT_Mode"));
+              state.get(Sig::MPPT_HeatsinkTemperature), state.get(Sig::MPPT_AmbientTemperature),
+              (uint8_t)state.get(Sig::MPPT_Fault), (uint8_t)state.get(Sig::MPPT_Mode));
   widgets::Space(4);
 
   // Cooling
-  const bool pumpFault = state.getBool("Pump_Fault");
+  const bool pumpFault = state.getBool(Sig::Pump_Fault);
   ImVec4 pumpCol = pumpFault ? Colors::Destructive() : Colors::Foreground();
   ImGui::TextColored(ImVec4(0.4f, 0.8f, 1.0f, 1.0f), "COOLING");
-  ImGui::Text(" Coolant: %.1f / %.1fC  Flow: %.2f / %.2f L/min", state.get("Coolant_Temperature_1"),
-              state.get("Coolant_Temperature_2"), state.get("FlowRate_1"), state.get("FlowRate_2"));
-  ImGui::TextColored(pumpCol, " Pump: %d%% %s", (uint8_t)state.get("Pump_DutyCycle"),
+  ImGui::Text(" Coolant: %.1f / %.1fC  Flow: %.2f / %.2f L/min",
+              state.get(Sig::Coolant_Temperature_1), state.get(Sig::Coolant_Temperature_2),
+              state.get(Sig::FlowRate_1), state.get(Sig::FlowRate_2));
+  ImGui::TextColored(pumpCol, " Pump: %d%% %s", (uint8_t)state.get(Sig::Pump_DutyCycle),
                      pumpFault ? "FAULT" : "OK");
   widgets::Space(4);
 
   // LV + Cameras + Lights
   ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.9f, 1.0f), "LV / CAMERAS / LIGHTS");
   ImGui::Text(" HV DCDC: Sel:%s Fault:%s Valid:%s",
-              state.getBool("LTC4421_HVDCDC_Selected") ? "Y" : "N",
-              state.getBool("LTC4421_HVDCDC_Fault") ? "YES" : "no",
-              state.getBool("LTC4421_HVDCDC_Valid") ? "Y" : "N");
+              state.getBool(Sig::LTC4421_HVDCDC_Selected) ? "Y" : "N",
+              state.getBool(Sig::LTC4421_HVDCDC_Fault) ? "YES" : "no",
+              state.getBool(Sig::LTC4421_HVDCDC_Valid) ? "Y" : "N");
   ImGui::Text(" Supp Batt: Sel:%s Fault:%s Valid:%s",
-              state.getBool("LTC4421_SuppBatt_Selected") ? "Y" : "N",
-              state.getBool("LTC4421_SuppBatt_Fault") ? "YES" : "no",
-              state.getBool("LTC4421_SuppBatt_Valid") ? "Y" : "N");
+              state.getBool(Sig::LTC4421_SuppBatt_Selected) ? "Y" : "N",
+              state.getBool(Sig::LTC4421_SuppBatt_Fault) ? "YES" : "no",
+              state.getBool(Sig::LTC4421_SuppBatt_Valid) ? "Y" : "N");
   ImGui::Text(" Enable: SuppBatt:%s PSU:%s",
-              state.getBool("LV_EN_SupplementalBattery") ? "ON" : "off",
-              state.getBool("LV_EN_PowerSupply") ? "ON" : "off");
+              state.getBool(Sig::LV_EN_SupplementalBattery) ? "ON" : "off",
+              state.getBool(Sig::LV_EN_PowerSupply) ? "ON" : "off");
   ImGui::Text(" Supp Batt Info: SOC: %.1f%%  %.1fV  %.1fA  Charger: %s  DCDC: %.1fV %.1fA",
-              state.get("Supplemental_Battery_SOC"), state.get("Supplemental_Battery_Voltage"),
-              state.get("Supplemental_Battery_Current") * 0.001,
-              SuppChargerStatusStr((uint8_t)state.get("SuppCharger_Status")),
-              state.get("Supplemental_DCDC_Voltage"),
-              state.get("Supplemental_DCDC_Current") * 0.001);
+              state.get(Sig::Supplemental_Battery_SOC),
+              state.get(Sig::Supplemental_Battery_Voltage),
+              state.get(Sig::Supplemental_Battery_Current) * 0.001,
+              SuppChargerStatusStr((uint8_t)state.get(Sig::SuppCharger_Status)),
+              state.get(Sig::Supplemental_DCDC_Voltage),
+              state.get(Sig::Supplemental_DCDC_Current) * 0.001);
   ImGui::Text(" Cameras: Backup:%s Left:%s Right:%s",
-              state.getBool("Camera_Status_Backup") ? "Y" : "N",
-              state.getBool("Camera_Status_Left") ? "Y" : "N",
-              state.getBool("Camera_Status_Right") ? "Y" : "N");
-  const uint8_t lightingFaults = (uint8_t)state.get("Controls_Lighting_Fault");
-  const uint8_t controlsLeaderFault = (uint8_t)state.get("Controls_Leader_Fault");
+              state.getBool(Sig::Camera_Status_Backup) ? "Y" : "N",
+              state.getBool(Sig::Camera_Status_Left) ? "Y" : "N",
+              state.getBool(Sig::Camera_Status_Right) ? "Y" : "N");
+  const uint8_t lightingFaults = (uint8_t)state.get(Sig::Controls_Lighting_Fault);
+  const uint8_t controlsLeaderFault = (uint8_t)state.get(Sig::Controls_Leader_Fault);
   ImVec4 ctlCol =
       (lightingFaults || controlsLeaderFault) ? Colors::Destructive() : Colors::Foreground();
   ImGui::TextColored(ctlCol, " Light Faults: %d  Controls Faults: %d", lightingFaults,
@@ -1272,13 +1278,13 @@ static void RenderDebugScreen(AppState& liveState) {
   widgets::Space(4);
 
   // BPS Status
-  const uint8_t bpsFaultCode = (uint8_t)state.get("BPS_Fault");
+  const uint8_t bpsFaultCode = (uint8_t)state.get(Sig::BPS_Fault);
   ImVec4 bpsFCol = bpsFaultCode != 0 ? Colors::Destructive() : ImVec4(0.4f, 1.0f, 0.4f, 1.0f);
   ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.3f, 1.0f), "BPS STATUS");
   ImGui::TextColored(bpsFCol, " Fault: %d (%s)  Regen: %s  Charge: %s", bpsFaultCode,
-                     BpsFaultName(bpsFaultCode), state.getBool("BPS_Regen_OK") ? "OK" : "NO",
-                     state.getBool("BPS_Charge_OK") ? "OK" : "NO");
-  const float mainBatteryAvgTemp = (float)state.get("Main_Battery_Avg_Temperature");
+                     BpsFaultName(bpsFaultCode), state.getBool(Sig::BPS_Regen_OK) ? "OK" : "NO",
+                     state.getBool(Sig::BPS_Charge_OK) ? "OK" : "NO");
+  const float mainBatteryAvgTemp = (float)state.get(Sig::Main_Battery_Avg_Temperature);
   if (mainBatteryAvgTemp > 0.0f) {
     ImGui::Text(" Avg Temp: %.1fC", mainBatteryAvgTemp);
   }
@@ -1331,8 +1337,8 @@ void RenderDashboard(AppState& state, ImGuiWindowFlags flags) {
   static uint8_t lastVcuFaultCode = 0;
   static uint16_t lastCanFaultId = 0;
 
-  const uint8_t bpsFaultCode = (uint8_t)state.get("BPS_Fault");
-  const uint8_t vcuFaultCode = (uint8_t)state.get("VCU_Fault");
+  const uint8_t bpsFaultCode = (uint8_t)state.get(Sig::BPS_Fault);
+  const uint8_t vcuFaultCode = (uint8_t)state.get(Sig::VCU_Fault);
 
   if (!state.showDebugScreen) {  // Only record edge-triggered snapshot when not actively browsing
                                  // snapshots
@@ -1,9 +1,80 @@
 #include "dashboard_tab.h"
 
+#include <cmath>
+#include <string_view>
+
 #include "dashboard.h"
 
 namespace ui {
 
+namespace {
+
+// Every tapped pack whose groups carry the named signal, in validIds order.
+std::vector<DashboardTab::TapSource> tapSources(const Arena& arena, std::string_view name) {
+  std::vector<DashboardTab::TapSource> found;
+  for (uint32_t id : arena.validIds) {
+    const Message* msg = arena.message(id);
+    if (!msg || !msg->tapped || msg->muxCount == 0) continue;
+    const Message& group = msg->muxGroups[0];
+    for (uint32_t i = 0; i < group.signalCount; i++) {
+      if (group.signals[i] && group.signals[i]->name == name) {
+        found.push_back({id, i});
+        break;
+      }
+    }
+  }
+  return found;
+}
+
+}  // namespace
+
+// Reads the newest value of every dashboard signal and tap. Names are only
+// resolved when a dbc load or resize replaces the arena.
+void DashboardTab::sync(const Arena& arena) {
+  if (arena.generation != generation) {
+    generation = arena.generation;
+    sources.assign(arena.storedMessages, Source{});
+    for (size_t i = 0; i < kSignalCount; i++) handles[i] = arena.resolve(kSignalNames[i]);
+    voltageTaps = tapSources(arena, "BPS_Voltage_Tap_Data");
+    temperatureTaps = tapSources(arena, "BPS_Temperature_Tap_Data");
+  }
+
+  for (size_t i = 0; i < kSignalCount; i++)
+    state.present[i] = arena.latest(handles[i], state.values[i]);
+
+  // taps not seen yet read as nan and are shown as 0
+  auto readTaps = [&](const std::vector<TapSource>& packs, std::vector<float>& out) {
+    out.clear();
+    for (const TapSource& pack : packs) {
+      taps.assign(MUX_GROUP_MAX, 0.0);
+      const uint32_t count = arena.latestTaps(pack.id, pack.signal, taps);
+      for (uint32_t t = 0; t < count; t++)
+        out.push_back(std::isnan(taps[t]) ? 0.0f : static_cast<float>(taps[t]));
+    }
+  };
+  readTaps(voltageTaps, state.moduleVoltages);
+  readTaps(temperatureTaps, state.moduleTemps);
+
+  const auto now = std::chrono::steady_clock::now();
+  LatestSnapshot latest;
+  for (uint32_t m = 0; m < arena.storedMessages; m++) {
+    Source& source = sources[m];
+    if (!arena.latest(arena.messageStore[m], latest) || latest.updates == source.updates)
+      continue;
+    source.updates = latest.updates;
+    source.seen = now;
+  }
+
+  // Seconds since the message last published, measured here rather than from
+  // its timestamps since those come from the car's clock.
+  auto age = [&](const SignalHandle& handle) {
+    if (!arena.message(handle) || sources[handle.message].updates == 0) return -1.0;
+    return std::chrono::duration<double>(now - sources[handle.message].seen).count();
+  };
+  state.bpsMsgAgeSeconds = age(handles[static_cast<size_t>(Sig::BPS_Fault)]);
+  state.vcuMsgAgeSeconds = age(handles[static_cast<size_t>(Sig::VCU_Fault)]);
+}
+
 void DashboardTab::draw(ImGuiWindowFlags flags) { RenderDashboard(state, flags); }
 
 DashboardTab& dashboardTab() {
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <vector>
+
+#include "../../parse/arena.hpp"
 #include "imgui.h"
 #include "state.h"
 
@@ -8,6 +13,26 @@ namespace ui {
 struct DashboardTab {
   AppState state = CreateDefaultState();
 
+  // One per arena message, only tracks when it last published so the fault
+  // messages can be aged.
+  struct Source {
+    uint64_t updates = 0;
+    std::chrono::steady_clock::time_point seen{};
+  };
+  // A VoltTemp board's tap pack and the group signal holding its readings.
+  struct TapSource {
+    uint32_t id{};
+    uint32_t signal{};
+  };
+  std::vector<Source> sources;
+  std::vector<TapSource> voltageTaps;
+  std::vector<TapSource> temperatureTaps;
+  std::vector<double> taps;
+  // Resolved once per arena generation, indexed by Sig.
+  std::array<SignalHandle, kSignalCount> handles{};
+  uint64_t generation = UINT64_MAX;
+
+  void sync(const Arena& arena);
   void draw(ImGuiWindowFlags flags);
 };
 
@@ -1,8 +1,9 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 namespace ui {
@@ -20,23 +21,141 @@ struct Fault {
   int64_t timestamp;  // Unix timestamp in milliseconds
 };
 
+// Every DBC signal the dashboard reads. DashboardTab::sync resolves each name to
+// a SignalHandle once per arena generation and reads it through Arena::latest,
+// so drawing never hashes a string.
+#define DASHBOARD_SIGNALS(X)          \
+  X(BPS_Fault)                        \
+  X(VCU_Fault)                        \
+  X(Main_Battery_Current)             \
+  X(BPS_SoC)                          \
+  X(Main_Battery_Voltage)             \
+  X(Supplemental_Battery_SOC)         \
+  X(Supplemental_Battery_Voltage)     \
+  X(Supplemental_Battery_Current)     \
+  X(MC_HeatsinkTemp)                  \
+  X(MC_BusVoltage)                    \
+  X(MC_BusCurrent)                    \
+  X(Main_Battery_Avg_Temperature)     \
+  X(HV_Plus_Contactor_State)          \
+  X(HV_Minus_Contactor_State)         \
+  X(Array_Precharge_Contactor_State)  \
+  X(Array_Contactor_State)            \
+  X(Motor_Precharge_Contactor_State)  \
+  X(Motor_Contactor_State)            \
+  X(Ignition_Off)                     \
+  X(Ignition_Array)                   \
+  X(Ignition_Motor)                   \
+  X(Cruise_Enable)                    \
+  X(Regen_Enable)                     \
+  X(AccelPedal_Main_Pos)              \
+  X(Brake_Pressure_1)                 \
+  X(Brake_Pressure_2)                 \
+  X(Brake_Pressure_1_Fault)           \
+  X(Brake_Pressure_2_Fault)           \
+  X(LWS_Fault)                        \
+  X(LWS_Angle)                        \
+  X(Horn_Pressed)                     \
+  X(Hazard_Pressed)                   \
+  X(PushToTalk_Pressed)               \
+  X(Cruise_Set)                       \
+  X(Regen_Activate)                   \
+  X(AccelPedal_Redundant_Pos)         \
+  X(Accel_Pos_Voltage_Main)           \
+  X(Accel_Pos_Voltage_Redundant)      \
+  X(AccelPedal_Main_Fault)            \
+  X(AccelPedal_Redundant_Fault)       \
+  X(BrakePedal_Main_Pos)              \
+  X(BrakePedal_Redundant_Pos)         \
+  X(Brake_Pos_Voltage_Main)           \
+  X(Brake_Pos_Voltage_Redundant)      \
+  X(BrakePedal_Main_Fault)            \
+  X(BrakePedal_Redundant_Fault)       \
+  X(MC_LIMIT_MotorCurrent)            \
+  X(MC_LIMIT_Velocity)                \
+  X(MC_LIMIT_BusCurrent)              \
+  X(MC_LIMIT_BusVoltageUpper)         \
+  X(MC_LIMIT_BusVoltageLower)         \
+  X(MC_LIMIT_MotorTemp)               \
+  X(MC_LIMIT_OutputVoltagePWM)        \
+  X(MC_PhaseCurrentB)                 \
+  X(MC_PhaseCurrentC)                 \
+  X(MC_BEMFq)                         \
+  X(MC_BEMFd)                         \
+  X(VCU_Precharge_Motor_Voltage)      \
+  X(VCU_Pedals_Watchdog)              \
+  X(VCU_Driver_Input_Watchdog)        \
+  X(VCU_FSM_State)                    \
+  X(Motor_Ready)                      \
+  X(VCU_Regen_OK)                     \
+  X(VCU_Regen_Active)                 \
+  X(MPPT_Input_Voltage)               \
+  X(MPPT_Input_Current)               \
+  X(MPPT_Output_Voltage)              \
+  X(MPPT_Output_Current)              \
+  X(MPPT_HeatsinkTemperature)         \
+  X(MPPT_AmbientTemperature)          \
+  X(MPPT_Fault)                       \
+  X(MPPT_Mode)                        \
+  X(Pump_Fault)                       \
+  X(Coolant_Temperature_1)            \
+  X(Coolant_Temperature_2)            \
+  X(FlowRate_1)                       \
+  X(FlowRate_2)                       \
+  X(Pump_DutyCycle)                   \
+  X(LTC4421_HVDCDC_Selected)          \
+  X(LTC4421_HVDCDC_Fault)             \
+  X(LTC4421_HVDCDC_Valid)             \
+  X(LTC4421_SuppBatt_Selected)        \
+  X(LTC4421_SuppBatt_Fault)           \
+  X(LTC4421_SuppBatt_Valid)           \
+  X(LV_EN_SupplementalBattery)        \
+  X(LV_EN_PowerSupply)                \
+  X(SuppCharger_Status)               \
+  X(Supplemental_DCDC_Voltage)        \
+  X(Supplemental_DCDC_Current)        \
+  X(Camera_Status_Backup)             \
+  X(Camera_Status_Left)               \
+  X(Camera_Status_Right)              \
+  X(Controls_Lighting_Fault)          \
+  X(Controls_Leader_Fault)            \
+  X(BPS_Regen_OK)                     \
+  X(BPS_Charge_OK)
+
+enum class Sig : uint16_t {
+#define DASHBOARD_SIGNAL_ENUM(name) name,
+  DASHBOARD_SIGNALS(DASHBOARD_SIGNAL_ENUM)
+#undef DASHBOARD_SIGNAL_ENUM
+  Count
+};
+
+constexpr size_t kSignalCount = static_cast<size_t>(Sig::Count);
+
+inline constexpr std::array<const char*, kSignalCount> kSignalNames = {
+#define DASHBOARD_SIGNAL_NAME(name) #name,
+    DASHBOARD_SIGNALS(DASHBOARD_SIGNAL_NAME)
+#undef DASHBOARD_SIGNAL_NAME
+};
+
 /**
- * Dashboard state. Raw CAN telemetry is read directly from `signals` by DBC
- * signal name (see get()/getBool()) rather than being copied into named
- * fields — only values that can't be a single raw signal (unit conversions,
- * multi-signal derivations, UI-only state) get dedicated fields below.
+ * Dashboard state. Raw CAN telemetry is the newest value of each Sig (see
+ * get()/getBool()/has()) rather than being copied into named fields — only
+ * values that can't be a single raw signal (unit conversions, multi-signal
+ * derivations, UI-only state) get dedicated fields below.
  */
 struct AppState {
-  std::unordered_map<std::string, double> signals;
+  std::array<double, kSignalCount> values{};
+  // false until the signal's message has published in the current arena
+  std::array<bool, kSignalCount> present{};
+
+  bool has(Sig sig) const { return present[static_cast<size_t>(sig)]; }
 
-  double get(const std::string& name, double fallback = 0.0) const {
-    auto it = signals.find(name);
-    return it != signals.end() ? it->second : fallback;
+  double get(Sig sig, double fallback = 0.0) const {
+    return has(sig) ? values[static_cast<size_t>(sig)] : fallback;
   }
 
-  bool getBool(const std::string& name, bool fallback = false) const {
-    auto it = signals.find(name);
-    return it != signals.end() ? it->second != 0.0 : fallback;
+  bool getBool(Sig sig, bool fallback = false) const {
+    return has(sig) ? values[static_cast<size_t>(sig)] != 0.0 : fallback;
   }
 
   // Derived from MC_VehicleVelocity (m/s), converted to mph.
@@ -51,7 +170,8 @@ struct AppState {
   // Derived from BrakePedal_Main_Pos and Brake_Pressure_{1,2} thresholds.
   bool brakeEngaged = false;
 
-  // BPS_Voltage_Tap_Data / BPS_Temperature_Tap_Data unpacked by BPS_Tap_idx.
+  // BPS_Voltage_Tap_Data / BPS_Temperature_Tap_Data of every tap of every
+  // VoltTemp board, in board order, 0 until a tap has been seen.
   std::vector<float> moduleVoltages;
   std::vector<float> moduleTemps;
 
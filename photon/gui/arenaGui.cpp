@@ -125,6 +125,8 @@ struct UiRing {
 struct MessageUiStats {
   bool initialized{};
   uint32_t lastBytes{};
+  // bytes appended since the last clear, keeps counting once a ring buffer is full
+  uint64_t lastHead{};
   uint32_t sampleCount{};
   size_t heldBytes{};
   double lastPollTime{};
@@ -135,6 +137,7 @@ struct MessageUiStats {
   void reset() {
     initialized = false;
     lastBytes = 0;
+    lastHead = 0;
     sampleCount = 0;
     heldBytes = 0;
     lastPollTime = 0.0;
@@ -155,29 +158,34 @@ ArenaUiFrameStats refreshArenaUiStats(Arena& arena,
   const double now = ImGui::GetTime();
 
   for (const uint32_t id : arena.validIds) {
-    if (id >= arena.messages.size() || !arena.messages[id]) continue;
+    Message* found = arena.message(id);
+    if (!found) continue;
 
-    Message& msg = *arena.messages[id];
-    MessageUiStats& stats = cache[id];
+    Message& msg = *found;
+    MessageUiStats& stats = cache[msg.index];
     const uint32_t signalBytes = msg.signalSize.value.load(std::memory_order_acquire);
+    const uint64_t headBytes = msg.counters.head.load(std::memory_order_acquire);
+    // decode caches of raw and typed messages are not counted, see Message::frameBits
     stats.sampleCount = signalBytes / sizeof(double);
-    stats.heldBytes = static_cast<size_t>(signalBytes) * (static_cast<size_t>(msg.signalCount) + 1);
+    stats.heldBytes = static_cast<size_t>(stats.sampleCount) * msg.frameBits / 8;
 
     if (!stats.initialized) {
       stats.initialized = true;
       stats.lastBytes = signalBytes;
+      stats.lastHead = headBytes;
       stats.lastPollTime = now;
       stats.lastChangeTime = signalBytes > 0 ? now : 0.0;
       stats.dataRate = 0.0;
     } else {
-      const uint32_t deltaBytes =
-          signalBytes >= stats.lastBytes ? signalBytes - stats.lastBytes : signalBytes;
+      const uint64_t deltaBytes =
+          headBytes >= stats.lastHead ? headBytes - stats.lastHead : headBytes;
       const double elapsed = now - stats.lastPollTime;
       const size_t deltaHeldBytes =
-          static_cast<size_t>(deltaBytes) * (static_cast<size_t>(msg.signalCount) + 1);
+          static_cast<size_t>(deltaBytes / sizeof(double)) * msg.frameBits / 8;
       stats.dataRate = elapsed > 0.0 ? static_cast<double>(deltaHeldBytes) / elapsed : 0.0;
-      if (deltaBytes > 0 || signalBytes < stats.lastBytes) stats.lastChangeTime = now;
+      if (deltaBytes > 0 || headBytes < stats.lastHead) stats.lastChangeTime = now;
       stats.lastBytes = signalBytes;
+      stats.lastHead = headBytes;
       stats.lastPollTime = now;
     }
 
@@ -186,9 +194,10 @@ ArenaUiFrameStats refreshArenaUiStats(Arena& arena,
   }
 
   for (const uint32_t id : arena.validIds) {
-    if (id >= arena.messages.size() || !arena.messages[id]) continue;
+    const Message* msg = arena.message(id);
+    if (!msg) continue;
 
-    MessageUiStats& stats = cache[id];
+    MessageUiStats& stats = cache[msg->index];
     stats.bandwidthFraction = frame.netDataRate > 0.0 ? stats.dataRate / frame.netDataRate : 0.0;
   }
 
@@ -223,8 +232,10 @@ inline bool containsQuery(const char* text, const char* query, size_t queryLen)
   return std::strstr(normalized, query) != nullptr;
 }
 
+// ids are matched without their bus and extended flag bits
 inline bool idMatchesQuery(uint32_t id, const char* query, size_t queryLen) {
   if (queryLen == 0) return true;
+  id = messageCanId(id) & ~CAN_EXTENDED_FLAG;
 
   char idText[32];
   std::snprintf(idText, sizeof(idText), "%u", id);
@@ -237,11 +248,11 @@ inline bool idMatchesQuery(uint32_t id, const char* query, size_t queryLen) {
 bool messageMatchesQuery(const Message& msg, const char* query, size_t queryLen) {
   if (queryLen == 0) return true;
   if (idMatchesQuery(msg.id, query, queryLen)) return true;
-  if (containsQuery(msg.name.c_str(), query, queryLen)) return true;
-  if (containsQuery(msg.transmitter.c_str(), query, queryLen)) return true;
+  if (containsQuery(msg.name, query, queryLen)) return true;
+  if (containsQuery(msg.transmitter, query, queryLen)) return true;
 
   for (size_t s = 0; s < msg.signalCount; s++) {
-    if (msg.signals[s] && containsQuery(msg.signals[s]->name.c_str(), query, queryLen)) return true;
+    if (msg.signals[s] && containsQuery(msg.signals[s]->name, query, queryLen)) return true;
   }
   return false;
 }
@@ -288,7 +299,7 @@ void drawLivePanel(const char* id, const char* label, const char* value, const c
 }
 
 void drawStaticInfoStrip(float width, const ArenaPalette& palette, size_t capacityBytes,
-                         size_t arenaSize, size_t bytesPerBuffer, size_t totalPages,
+                         size_t arenaSize, double retention, size_t totalPages,
                          uint32_t totalBuffers, uint32_t totalTimeBuffers, uint32_t totalSignals,
                          size_t messageCount) {
   const float height = 54.0f;
@@ -307,7 +318,7 @@ void drawStaticInfoStrip(float width, const ArenaPalette& palette, size_t capaci
   Item items[7] = {
       {"Pool", ""},
       {"Capacity per sample", ""},
-      {"Capacity per signal", ""},
+      {"Retention target", ""},
       {"Messages", ""},
       {"Signals", ""},
       {"Buffers", ""},
@@ -315,7 +326,10 @@ void drawStaticInfoStrip(float width, const ArenaPalette& palette, size_t capaci
   };
   formatBytes(items[0].value, sizeof(items[0].value), arenaSize);
   formatBytes(items[1].value, sizeof(items[1].value), capacityBytes);
-  formatBytes(items[2].value, sizeof(items[2].value), bytesPerBuffer);
+  if (retention > 0.0)
+    std::snprintf(items[2].value, sizeof(items[2].value), "%.0f s", retention);
+  else
+    std::snprintf(items[2].value, sizeof(items[2].value), "none");
   std::snprintf(items[3].value, sizeof(items[3].value), "%llu",
                 static_cast<unsigned long long>(messageCount));
   std::snprintf(items[4].value, sizeof(items[4].value), "%u", totalSignals);
@@ -341,7 +355,7 @@ void drawStaticInfoStrip(float width, const ArenaPalette& palette, size_t capaci
 
 void drawArenaHeader(float width, const ArenaPalette& palette, const ArenaUiFrameStats& frameStats,
                      const UiRing& netHistory, double smoothedNetDataRate, size_t capacityBytes,
-                     float heldFraction, size_t arenaSize, size_t bytesPerBuffer, size_t totalPages,
+                     float heldFraction, size_t arenaSize, double retention, size_t totalPages,
                      uint32_t totalBuffers, uint32_t totalTimeBuffers, uint32_t totalSignals,
                      size_t messageCount) {
   const ImGuiStyle& style = ImGui::GetStyle();
@@ -363,7 +377,7 @@ void drawArenaHeader(float width, const ArenaPalette& palette, const ArenaUiFram
   std::snprintf(detail, sizeof(detail), "%s", percent);
   drawLivePanel("storage", "Storage", value, detail, {storageW, liveH}, palette, nullptr,
                 heldFraction);
-  drawStaticInfoStrip(width, palette, capacityBytes, arenaSize, bytesPerBuffer, totalPages,
+  drawStaticInfoStrip(width, palette, capacityBytes, arenaSize, retention, totalPages,
                       totalBuffers, totalTimeBuffers, totalSignals, messageCount);
 }
 
@@ -392,11 +406,18 @@ bool drawMessageRow(const Message& msg, const MessageUiStats& stats, bool expand
                             rounding, 5.0f);
   draw->AddRect(min, max, colorU32(withAlpha(palette.border, 0.36f + focus * 0.24f)), rounding);
 
-  char idText[32];
-  std::snprintf(idText, sizeof(idText), "0x%X", msg.id);
+  char idText[48];
+  const uint32_t canId = messageCanId(msg.id);
+  int idLen = 0;
+  if (canId & CAN_EXTENDED_FLAG)
+    idLen = std::snprintf(idText, sizeof(idText), "0x%08X ext", canId & CAN_EXTENDED_MASK);
+  else
+    idLen = std::snprintf(idText, sizeof(idText), "0x%X", canId);
+  if (msg.bus != 0 && idLen > 0)
+    std::snprintf(idText + idLen, sizeof(idText) - idLen, "  bus %u", msg.bus);
   const float statStart = width > 660.0f ? max.x - 344.0f : max.x;
   draw->PushClipRect({min.x + 16.0f, min.y}, {statStart - 18.0f, max.y}, true);
-  draw->AddText({min.x + 16.0f, min.y + 10.0f}, colorU32(palette.text), msg.name.c_str());
+  draw->AddText({min.x + 16.0f, min.y + 10.0f}, colorU32(palette.text), msg.name);
   draw->AddText({min.x + 16.0f, min.y + 34.0f}, colorU32(palette.muted), idText);
   draw->PopClipRect();
 
@@ -447,14 +468,13 @@ void Arena::statusUI(int flags) {
     const ArenaPalette palette = PhotonUi::palette();
     const ImGuiStyle& style = ImGui::GetStyle();
     const float contentWidth = ImGui::GetContentRegionAvail().x;
-    const size_t capacityBytes = bytesPerBuffer * totalBuffers;
     const float heldFraction = capacityBytes > 0 ? static_cast<float>(frameStats.heldBytes) /
                                                        static_cast<float>(capacityBytes)
                                                  : 0.0f;
     char buf[64];
 
     drawArenaHeader(contentWidth, palette, frameStats, netDataRateHistory, smoothedNetDataRate,
-                    capacityBytes, heldFraction, arenaSize, bytesPerBuffer, totalPages,
+                    capacityBytes, heldFraction, arenaSize, retention, totalPages,
                     totalBuffers, totalTimeBuffers, totalSignals, validIds.size());
 
     ImGui::Spacing();
@@ -476,17 +496,16 @@ void Arena::statusUI(int flags) {
     ImGui::Spacing();
     uint32_t visibleMessages = 0;
     for (const uint32_t id : validIds) {
-      if (id >= messages.size()) continue;
-      Message* msg = messages[id];
+      Message* msg = message(id);
       if (!msg) continue;
       if (!messageMatchesQuery(*msg, normalizedQuery, queryLen)) continue;
       visibleMessages++;
 
-      MessageUiStats& stats = uiStats[id];
-      if (drawMessageRow(*msg, stats, expandedMessages[id], contentWidth, palette))
-        expandedMessages[id] = !expandedMessages[id];
+      MessageUiStats& stats = uiStats[msg->index];
+      bool& expanded = expandedMessages[msg->index];
+      if (drawMessageRow(*msg, stats, expanded, contentWidth, palette)) expanded = !expanded;
 
-      if (expandedMessages[id]) {
+      if (expanded) {
         ImGui::PushID(static_cast<int>(msg->id));
         ImGui::PushStyleVar(ImGuiStyleVar_CellPadding, ImVec2(12.0f, 8.0f));
         ImGui::PushStyleColor(ImGuiCol_TableRowBg, withAlpha(palette.panel, 0.48f));
@@ -498,11 +517,12 @@ void Arena::statusUI(int flags) {
         constexpr ImGuiTableFlags metaFlags =
             ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_RowBg |
             ImGuiTableFlags_SizingStretchProp | ImGuiTableFlags_NoSavedSettings;
-        if (ImGui::BeginTable("message_meta", 6, metaFlags)) {
+        if (ImGui::BeginTable("message_meta", 7, metaFlags)) {
           ImGui::TableSetupColumn("DLC");
           ImGui::TableSetupColumn("TX");
           ImGui::TableSetupColumn("Transfer");
           ImGui::TableSetupColumn("Bandwidth");
+          ImGui::TableSetupColumn("Frames / s");
           ImGui::TableSetupColumn("Capacity");
           ImGui::TableSetupColumn("Signals");
           ImGui::TableHeadersRow();
@@ -510,7 +530,7 @@ void Arena::statusUI(int flags) {
           ImGui::TableSetColumnIndex(0);
           ImGui::Text("%u", msg->dlc);
           ImGui::TableSetColumnIndex(1);
-          ImGui::TextUnformatted(msg->transmitter.c_str());
+          ImGui::TextUnformatted(msg->transmitter);
           ImGui::TableSetColumnIndex(2);
           formatBytes(buf, sizeof(buf), static_cast<uint64_t>(stats.heldBytes));
           ImGui::TextUnformatted(buf);
@@ -518,12 +538,14 @@ void Arena::statusUI(int flags) {
           formatPercent(buf, sizeof(buf), stats.bandwidthFraction);
           ImGui::TextUnformatted(buf);
           ImGui::TableSetColumnIndex(4);
-          const float fillFraction = bytesPerBuffer > 0 ? static_cast<float>(stats.lastBytes) /
-                                                              static_cast<float>(bytesPerBuffer)
-                                                        : 0.0f;
+          ImGui::Text("%.1f of %.1f", measuredRate(*msg), msg->rate);
+          ImGui::TableSetColumnIndex(5);
+          const float fillFraction = msg->capacity > 0 ? static_cast<float>(stats.lastBytes) /
+                                                             static_cast<float>(msg->capacity)
+                                                       : 0.0f;
           formatPercent(buf, sizeof(buf), fillFraction);
           ImGui::TextUnformatted(buf);
-          ImGui::TableSetColumnIndex(5);
+          ImGui::TableSetColumnIndex(6);
           ImGui::Text("%u", msg->signalCount);
           ImGui::EndTable();
         }
@@ -543,13 +565,15 @@ void Arena::statusUI(int flags) {
           ImGui::TableSetupColumn("Unit");
           ImGui::TableSetupColumn("Age");
           ImGui::TableHeadersRow();
-          for (size_t s{0uz}; s < msg->signalCount; s++) {
-            Signal* sig = msg->signals[s];
-            if (!sig) continue;
+          // mux group signals follow the message's own, tapped packs list one tap for all
+          auto signalRow = [&](const Signal* sig, const char* suffix) {
             ImGui::TableNextRow();
 
             ImGui::TableSetColumnIndex(0);
-            ImGui::TextUnformatted(sig->name.c_str());
+            if (*suffix)
+              ImGui::Text("%s %s", sig->name, suffix);
+            else
+              ImGui::TextUnformatted(sig->name);
 
             ImGui::TableSetColumnIndex(1);
             std::snprintf(buf, sizeof(buf), "%d:%d %s", sig->startBit, sig->length,
@@ -572,12 +596,27 @@ void Arena::statusUI(int flags) {
             ImGui::Text("%.3f .. %.3f", sig->min, sig->max);
 
             ImGui::TableSetColumnIndex(6);
-            ImGui::TextUnformatted(sig->unit.c_str());
+            ImGui::TextUnformatted(sig->unit);
 
             ImGui::TableSetColumnIndex(7);
             formatAge(buf, sizeof(buf),
                       stats.lastChangeTime > 0.0 ? ImGui::GetTime() - stats.lastChangeTime : -1.0);
             ImGui::TextUnformatted(buf);
+          };
+          for (size_t s{0uz}; s < msg->signalCount; s++) {
+            const bool multiplexor = msg->muxCount && s == msg->muxSignal;
+            if (msg->signals[s]) signalRow(msg->signals[s], multiplexor ? "[M]" : "");
+          }
+          const uint32_t groupRows = msg->tapped ? std::min(msg->muxCount, 1u) : msg->muxCount;
+          for (uint32_t g = 0; g < groupRows; g++) {
+            const Message& group = msg->muxGroups[g];
+            char suffix[32];
+            if (msg->tapped)
+              std::snprintf(suffix, sizeof(suffix), "[%u taps]", msg->muxCount);
+            else
+              std::snprintf(suffix, sizeof(suffix), "[m%u]", group.muxValue);
+            for (size_t s{0uz}; s < group.signalCount; s++)
+              if (group.signals[s]) signalRow(group.signals[s], suffix);
           }
           ImGui::EndTable();
         }
@@ -1,11 +1,13 @@
 #include "gui.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <csignal>
 #include <cstddef>
 #include <cstdio>
 #include <locale>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -31,9 +33,12 @@
 #include "uiComponents.hpp"
 #include "widget.hpp"
 
-void GUI::init(GPU& gpu, Arena& arena, Network& network) {
+void GUI::init(GPU& gpu, Parse& parse, Network& network) {
   this->gpu = &gpu;
-  this->arena = &arena;
+  this->parse = &parse;
+  arenaReader.attach(parse);
+  this->arena = arenaReader.lock();
+  arenaReader.unlock();
   this->network = &network;
   GuiSettings::regster(&settings);
   settings.setStyle();
@@ -69,6 +74,7 @@ void GUI::destroy() {
   }
   testShader.destroy();
   buttonShader.destroy();
+  arenaReader.detach();
 };
 
 void GUI::setFont() {
@@ -118,29 +124,66 @@ void GUI::exportUI() {
 
 void GUI::genericPlot(uint32_t id, uint32_t signal, ImVec2 size) {
   ImPlotSpec spec = this->settings.plotLineSpec;
-  void* data = nullptr;
-  void* time = nullptr;
-  uint32_t timeBytes = 0;
-  uint32_t dataBytes = 0;
-  arena->read(id, signal, &data, &dataBytes);
-  arena->readTime(id, &time, &timeBytes);
-  if (!dataBytes || !timeBytes) return;
+  // the visible range is drawn through the arena's pyramid, one column per pixel at most,
+  // history the compactor sealed before the hot window takes up to half of them
+  constexpr uint32_t maxPlotColumns = 4096;
+  static std::array<double, maxPlotColumns> times{};
+  static std::array<double, maxPlotColumns> mins{};
+  static std::array<double, maxPlotColumns> maxs{};
+  static std::array<double, maxPlotColumns> means{};
+  const Message* msg = arena->message(id);
+  if (!msg || signal >= msg->signalCount || !msg->signals[signal]) return;
+  LatestSnapshot latest{};
+  if (!arena->latest(*msg, latest)) return;
+  ChunkCursor cursor = arena->chunks(*msg);
+  FrameChunk oldest{};
+  const double hotStart = cursor.next(oldest) ? oldest.time[0] : latest.time;
+
+  // the x range is linked so panning and zooming move it, a view that reached the newest
+  // sample keeps following it, a new one starts on the hot window
+  PlotView& view = plotViews[(uint64_t{id} << 32) | signal];
+  if (!view.placed) {
+    view = {.min = hotStart, .max = latest.time, .newest = latest.time, .placed = true};
+  } else if (view.max >= view.newest) {
+    view.min += latest.time - view.newest;
+    view.max += latest.time - view.newest;
+  }
+  view.newest = latest.time;
+
   char name[64];
   std::snprintf(name, sizeof(name), "##%u_%u", id, signal);
-  const char* signalName = arena->messages[id]->signals[signal]->name.c_str();
-  constexpr uint32_t maxPlotSamples = 100;
-  const uint32_t sampleCount = std::min(dataBytes, timeBytes) / sizeof(double);
-  const uint32_t visibleCount = std::min(sampleCount, maxPlotSamples);
-  if (visibleCount == 0) return;
-  const uint32_t firstSample = sampleCount - visibleCount;
-  const auto* timeValues = static_cast<const double*>(time) + firstSample;
-  const auto* dataValues = static_cast<const double*>(data) + firstSample;
-  if (ImPlot::BeginPlot(name, size)) {
-    ImPlot::SetupAxes("time", "value", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
-    ImPlot::SetupAxisScale(ImAxis_X1, ImPlotScale_Time);
-    ImPlot::PlotLine(signalName, timeValues, dataValues, static_cast<int>(visibleCount), spec);
-    ImPlot::EndPlot();
+  const char* signalName = msg->signals[signal]->name;
+  if (!ImPlot::BeginPlot(name, size)) return;
+  ImPlot::SetupAxes("time", "value", ImPlotAxisFlags_None, ImPlotAxisFlags_AutoFit);
+  ImPlot::SetupAxisScale(ImAxis_X1, ImPlotScale_Time);
+  ImPlot::SetupAxisLinks(ImAxis_X1, &view.min, &view.max);
+  ImPlot::SetupFinish();
+
+  // only what is on screen is read, zooming in reaches finer levels through the time index
+  const ImPlotRect limits = ImPlot::GetPlotLimits();
+  const auto pixels = static_cast<uint32_t>(
+      std::clamp(ImPlot::GetPlotSize().x, 1.0f, float{maxPlotColumns}));
+  const uint32_t coldPixels = limits.X.Max < hotStart ? pixels : pixels / 2;
+  const uint32_t coldCount =
+      parse ? parse->cold.readLod(*arena, id, signal, limits.X.Min, limits.X.Max, coldPixels,
+                                  {times, mins, maxs, means})
+            : 0;
+  auto rest = [&](std::array<double, maxPlotColumns>& columns) {
+    return std::span(columns).subspan(coldCount);
+  };
+  const uint32_t visibleCount =
+      coldCount + arena->readLod(id, signal, limits.X.Min, limits.X.Max, pixels - coldCount,
+                                 {rest(times), rest(mins), rest(maxs), rest(means)});
+  if (visibleCount > 0) {
+    // the band is each column's min to max, the line its mean
+    ImPlotSpec band = spec;
+    band.FillAlpha *= 0.35f;
+    band.Flags |= ImPlotItemFlags_NoLegend;
+    ImPlot::PlotShaded(signalName, times.data(), mins.data(), maxs.data(),
+                       static_cast<int>(visibleCount), band);
+    ImPlot::PlotLine(signalName, times.data(), means.data(), static_cast<int>(visibleCount), spec);
   }
+  ImPlot::EndPlot();
 };
 
 void GUI::plotTest(ImGuiWindowFlags flags) {
@@ -148,8 +191,9 @@ void GUI::plotTest(ImGuiWindowFlags flags) {
     auto dim = ImGui::GetContentRegionAvail();
     dim.y = 0;
     for (const uint32_t id : arena->validIds) {
-      if (id >= arena->messages.size() || !arena->messages[id]) continue;
-      for (uint32_t signal = 0; signal < arena->messages[id]->signalCount; signal++)
+      const Message* msg = arena->message(id);
+      if (!msg) continue;
+      for (uint32_t signal = 0; signal < msg->signalCount; signal++)
         genericPlot(id, signal, dim);
     }
   }
@@ -278,6 +322,8 @@ void GUI::setTabs() {
 
 void GUI::buildUI() {
   /* Per-Frame state updates */
+  arena = arenaReader.lock();
+  ui::dashboardTab().sync(*arena);
   updateAvailable = updater.updateAvailable.load();
   settings.setStyle();
   setFont();
@@ -298,4 +344,8 @@ void GUI::buildUI() {
   ifKey(ImGuiKey_F3, flags.showGPUInfo, gpuGUI::buildUI, *gpu);
   ImGui::Render();
   render();
+
+  /* draw data holds copies, the arena can be released before presenting */
+  arenaReader.unlock();
+  parse->reclaim();
 };
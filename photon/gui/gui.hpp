@@ -1,8 +1,12 @@
 #pragma once
+#include <cstdint>
+#include <unordered_map>
+
 #include "../gpu/gpu.hpp"
 #include "../gpu/shader.hpp"
 #include "../network/network.hpp"
 #include "../parse/arena.hpp"
+#include "../parse/parse.hpp"
 #include "../parse/spmc.hpp"
 #include "canvas.hpp"
 #include "config.hpp"
@@ -13,7 +17,7 @@
 #include "updater.hpp"
 
 struct GUI {
-  void init(GPU& gpu, Arena& arena, Network& network);
+  void init(GPU& gpu, Parse& parse, Network& network);
   void setTabs();
   void destroy();
   void setFont();
@@ -31,7 +35,10 @@ struct GUI {
   void drawButtonShaderOverlay(ImVec2 buttonMin, ImVec2 buttonMax);
 
   GPU* gpu;
+  // pinned for the length of one buildUI, a dbc swap mid frame cannot free it
   Arena* arena;
+  ArenaReader arenaReader{};
+  Parse* parse;
   Network* network;
 
   TitleBar titleBar{};
@@ -44,6 +51,14 @@ struct GUI {
   GuiFlags flags{};
   bool updateAvailable = false;
   std::vector<Plots> plots;
+  // x range of each genericPlot, keyed by message id and signal
+  struct PlotView {
+    double min{};
+    double max{};
+    double newest{};
+    bool placed{};
+  };
+  std::unordered_map<uint64_t, PlotView> plotViews{};
   Updater updater;
 };
 
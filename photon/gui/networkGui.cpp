@@ -2,6 +2,7 @@
 #include <array>
 #include <string>
 #include <variant>
+#include <vector>
 
 #include "gui.hpp"
 #include "imgui.h"
@@ -25,37 +26,49 @@ constexpr std::array<ProtocolOption, 7> kProtocols{{
 }};
 
 void submit(Network* network, TCPConfig config) {
-  network->guiRxCommandBuffer.write([config](ProtocolTransmitVariant& cmd) { cmd = config; });
+  network->submit(config);
 }
 
 void submit(Network* network, UDPConfig config) {
-  network->guiRxCommandBuffer.write([config](ProtocolTransmitVariant& cmd) { cmd = config; });
+  network->submit(config);
 }
 
 void submit(Network* network, UARTConfig config) {
-  network->guiRxCommandBuffer.write([config](ProtocolTransmitVariant& cmd) { cmd = config; });
+  network->submit(config);
 }
 
 void submit(Network* network, PCANConfig config) {
-  network->guiRxCommandBuffer.write([config](ProtocolTransmitVariant& cmd) { cmd = config; });
+  network->submit(config);
 }
 
 void submit(Network* network, BLEConfig config) {
-  network->guiRxCommandBuffer.write([config](ProtocolTransmitVariant& cmd) { cmd = config; });
+  network->submit(config);
 }
 
 void submit(Network* network, WLANConfig config) {
-  network->guiRxCommandBuffer.write([config](ProtocolTransmitVariant& cmd) { cmd = config; });
+  network->submit(config);
 }
 
 void disconnect(Network* network) {
-  network->guiRxCommandBuffer.write([](ProtocolTransmitVariant& cmd) { cmd = Quit{}; });
+  network->submit(Quit{});
 }
 
-void drainNetworkLog(Network* network, std::string& log) {
+// the newest counters of each source, kept after it stops so the last report stays visible
+void updateLinkStats(std::vector<ProtocolLinkStats>& links, const ProtocolLinkStats& stats) {
+  for (auto& link : links)
+    if (link.source == stats.source) {
+      link = stats;
+      return;
+    }
+  links.push_back(stats);
+}
+
+void drainNetworkLog(Network* network, std::string& log, std::vector<ProtocolLinkStats>& links) {
   static auto reader = network->guiTxCommandBuffer.getReader();
   while (ProtocolReceiveVariant* msg = reader.read()) {
-    if (auto* error = std::get_if<ProtocolError>(msg)) {
+    if (auto* stats = std::get_if<ProtocolLinkStats>(msg)) {
+      updateLinkStats(links, *stats);
+    } else if (auto* error = std::get_if<ProtocolError>(msg)) {
       log += "[error] " + error->error + "\n";
     } else if (auto* message = std::get_if<ProtocolMessage>(msg)) {
       log += message->message + "\n";
@@ -115,12 +128,23 @@ void drawPcanFields(PCANConfig& config, const PhotonUi::Palette& palette) {
   ImGui::InputScalar("Bitrate", ImGuiDataType_U32, &config.bitrateKbps);
   ImGui::SetNextItemWidth(140.0f);
   ImGui::InputFloat("Sample", &config.samplePointPercent);
+  ImGui::SetNextItemWidth(140.0f);
+  ImGui::InputScalar("Bus", ImGuiDataType_U32, &config.bus);
   ImGui::Checkbox("Listen only", &config.listenOnly);
   ImGui::SameLine();
   ImGui::Checkbox("Bus reset", &config.busoffReset);
   PhotonUi::popInputStyle();
 }
 
+void drawLinkStats(const std::vector<ProtocolLinkStats>& links) {
+  for (const auto& link : links)
+    ImGui::TextDisabled("%s  %.0f frames/s  %llu lost  %llu late  %llu malformed",
+                        link.source.c_str(), link.framesPerSecond,
+                        static_cast<unsigned long long>(link.lost),
+                        static_cast<unsigned long long>(link.reordered),
+                        static_cast<unsigned long long>(link.malformed));
+}
+
 void drawLogPanel(std::string& log, const PhotonUi::Palette& palette) {
   if (PhotonUi::beginPanel("##NetworkLog", {-1.0f, -1.0f}, palette)) {
     PhotonUi::label("Output", palette);
@@ -140,6 +164,7 @@ void drawLogPanel(std::string& log, const PhotonUi::Palette& palette) {
 void GUI::networkPage(ImGuiWindowFlags flags) {
   static int selected = 0;
   static std::string log;
+  static std::vector<ProtocolLinkStats> links;
   static TCPConfig daqConfig{.port = 6500, .ip = "3.141.38.115"};
   static TCPConfig tcpConfig{};
   static UDPConfig udpConfig{};
@@ -148,7 +173,7 @@ void GUI::networkPage(ImGuiWindowFlags flags) {
   static BLEConfig bleConfig{};
   static WLANConfig wlanConfig{};
 
-  drainNetworkLog(network, log);
+  drainNetworkLog(network, log, links);
 
   if (ImGui::Begin("Network", nullptr, flags)) {
     const PhotonUi::Palette palette = PhotonUi::palette();
@@ -197,6 +222,7 @@ void GUI::networkPage(ImGuiWindowFlags flags) {
         if (PhotonUi::button("ApplyWlan", "Apply", {96.0f, 34.0f}, palette, true))
           submit(network, wlanConfig);
       }
+      drawLinkStats(links);
     }
     PhotonUi::endPanel();
 
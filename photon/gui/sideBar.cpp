@@ -4,9 +4,12 @@
 #include <SDL3/SDL_error.h>
 
 #include <algorithm>
+#include <filesystem>
 #include <iterator>
+#include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include "background_jpg.hpp"
 #include "gui.hpp"
@@ -24,6 +27,10 @@ constexpr SDL_DialogFileFilter kDBCFileFilters[] = {
     {"DBC files", "dbc"},
     {"All files", "*"},
 };
+constexpr SDL_DialogFileFilter kSessionFileFilters[] = {
+    {"Photon sessions", "photon"},
+    {"All files", "*"},
+};
 
 using SidebarPalette = PhotonUi::Palette;
 using PhotonUi::colorU32;
@@ -172,6 +179,32 @@ bool drawDBCOption(const char* label, bool selected, float width, const SidebarP
   return PhotonUi::rowButton(label, icon, label, {width, 36.0f}, palette, selected);
 }
 
+// storage layouts a load can build, see arenaConfig, the flag of the one chosen is the only
+// one set and columnar has none
+struct LayoutOption {
+  const char* label;
+  bool Parse::* flag;
+};
+constexpr LayoutOption kLayoutOptions[] = {
+    {"Columnar storage", nullptr},
+    {"Blocked storage", &Parse::blocked},
+    {"Raw storage", &Parse::raw},
+    {"Typed storage", &Parse::typed},
+};
+
+void drawLayoutOptions(Parse& parse, float width, const SidebarPalette& palette) {
+  bool columnar = true;
+  for (const LayoutOption& option : kLayoutOptions)
+    if (option.flag && parse.*option.flag) columnar = false;
+  for (const LayoutOption& option : kLayoutOptions) {
+    const bool selected = option.flag ? parse.*option.flag : columnar;
+    if (!drawDBCOption(option.label, selected, width, palette)) continue;
+    for (const LayoutOption& other : kLayoutOptions)
+      if (other.flag) parse.*other.flag = false;
+    if (option.flag) parse.*option.flag = true;
+  }
+}
+
 void drawUploadIcon(ImDrawList* draw, ImVec2 min, float height, ImU32 color) {
   const float x = min.x + 21.0f;
   const float y = min.y + height * 0.5f;
@@ -282,6 +315,25 @@ void SDLCALL dbcFileDialogCallback(void* userdata, const char* const* filelist,
   sidebar->dbcStatus.clear();
   sidebar->hasPendingDBCPath = true;
 }
+
+void SDLCALL sessionFileDialogCallback(void* userdata, const char* const* filelist, int filter) {
+  (void)filter;
+  auto* sidebar = static_cast<Sidebar*>(userdata);
+  if (!sidebar) return;
+
+  std::lock_guard lock(sidebar->dbcDialogMutex);
+  sidebar->dbcDialogActive = false;
+  if (!filelist) {
+    sidebar->dbcStatus = std::string("Session file dialog failed: ") + SDL_GetError();
+    sidebar->hasPendingSessionPath = false;
+    return;
+  }
+  if (!filelist[0]) return;
+
+  sidebar->pendingSessionPath = normalizeDialogPath(filelist[0]);
+  sidebar->dbcStatus.clear();
+  sidebar->hasPendingSessionPath = true;
+}
 }  // namespace
 
 ImTextureData* loadImguiTexture(const unsigned char* data, std::size_t size) {
@@ -300,6 +352,7 @@ ImTextureData* loadImguiTexture(const unsigned char* data, std::size_t size) {
 
 void Sidebar::drawDBCSelector(GUI& gui) {
   std::string selectedPath{};
+  std::string sessionPath{};
   {
     std::lock_guard lock(dbcDialogMutex);
     if (hasPendingDBCPath) {
@@ -307,15 +360,32 @@ void Sidebar::drawDBCSelector(GUI& gui) {
       pendingDBCPath.clear();
       hasPendingDBCPath = false;
     }
+    if (hasPendingSessionPath) {
+      sessionPath = std::move(pendingSessionPath);
+      pendingSessionPath.clear();
+      hasPendingSessionPath = false;
+    }
   }
 
   bool closeDBCModal = false;
   if (!selectedPath.empty()) {
-    const bool loaded = gui.network && gui.network->switchDBCFile(selectedPath);
+    std::string previous = std::exchange(busFiles[uploadBus], selectedPath);
+    std::vector<BusFile> files{};
+    for (uint32_t bus = 0; bus < CAN_BUS_MAX; bus++)
+      if (!busFiles[bus].empty()) files.push_back({bus, busFiles[bus]});
+    const bool loaded = gui.network && gui.network->switchDBCFiles(files);
+    if (!loaded) busFiles[uploadBus] = std::move(previous);
     std::lock_guard lock(dbcDialogMutex);
     dbcStatus = loaded ? "" : "Failed to load " + selectedPath;
     closeDBCModal = loaded;
   }
+  if (!sessionPath.empty()) {
+    const bool opened = gui.network && gui.network->openSession(sessionPath);
+    if (opened) busFiles = {};
+    std::lock_guard lock(dbcDialogMutex);
+    dbcStatus = opened ? "" : "Failed to open session " + sessionPath;
+    closeDBCModal = opened;
+  }
 
   const SidebarPalette palette = sidebarPalette();
   const float fullWidth = ImGui::GetContentRegionAvail().x;
@@ -335,7 +405,7 @@ void Sidebar::drawDBCSelector(GUI& gui) {
                               viewport->Pos.y + viewport->Size.y * 0.5f};
   const float maxModalWidth = std::max(280.0f, viewport->Size.x - 48.0f);
   const float modalWidth = std::min(440.0f, maxModalWidth);
-  const float modalHeight = std::min(360.0f, std::max(220.0f, viewport->Size.y - 48.0f));
+  const float modalHeight = std::min(480.0f, std::max(220.0f, viewport->Size.y - 48.0f));
   ImGui::SetNextWindowPos(modalCenter, 0, ImVec2(0.5f, 0.5f));
   ImGui::SetNextWindowSize({modalWidth, modalHeight});
   ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(10.0f, 10.0f));
@@ -358,12 +428,25 @@ void Sidebar::drawDBCSelector(GUI& gui) {
       const bool selected = parse && parse->activeDBC == kind;
       if (drawDBCOption(Parse::dbcName(kind), selected, popupWidth, palette)) {
         const bool loaded = gui.network && gui.network->switchDBC(kind);
+        if (loaded) busFiles = {};
         std::lock_guard lock(dbcDialogMutex);
         dbcStatus = loaded ? "" : std::string("Failed to load ") + Parse::dbcName(kind);
         if (loaded) ImGui::CloseCurrentPopup();
       }
     }
 
+    // an upload goes to the selected bus, the files of the other buses load with it
+    for (uint32_t bus = 0; bus < CAN_BUS_MAX; bus++) {
+      const std::string id = "Bus" + std::to_string(bus);
+      const std::string& file = busFiles[bus];
+      const std::string name =
+          file.empty() ? "no file" : std::filesystem::path(file).filename().string();
+      const std::string label = "Bus " + std::to_string(bus) + "  " + name;
+      const char* icon = uploadBus == bus ? "\uea5e" : "\uea6b";
+      if (PhotonUi::rowButton(id.c_str(), icon, label, {popupWidth, 36.0f}, palette,
+                              uploadBus == bus))
+        uploadBus = bus;
+    }
     if (drawPopupAction("UploadFile", "", dialogActive ? "Opening file picker" : "Upload file",
                         dialogActive, popupWidth, palette, true)) {
       {
@@ -378,6 +461,30 @@ void Sidebar::drawDBCSelector(GUI& gui) {
                              false);
     }
 
+    // layout and recording take effect from the next load, each load records into a new file
+    PhotonUi::label("Storage, from the next load", palette);
+    if (parse) drawLayoutOptions(*parse, popupWidth, palette);
+    if (parse && drawDBCOption("Record sessions", parse->persist, popupWidth, palette))
+      parse->persist = !parse->persist;
+    // compression starts and stops right away, what it sealed stays until the next load
+    if (parse && drawDBCOption("Compress history", parse->compact.load(), popupWidth, palette))
+      parse->compact.store(!parse->compact.load());
+    if (drawPopupAction("OpenSession", "\uea88",
+                        dialogActive ? "Opening file picker" : "Open session", dialogActive,
+                        popupWidth, palette)) {
+      {
+        std::lock_guard lock(dbcDialogMutex);
+        pendingSessionPath.clear();
+        hasPendingSessionPath = false;
+        dbcStatus.clear();
+        dbcDialogActive = true;
+      }
+      const std::string dir = sessionDir().string();
+      SDL_ShowOpenFileDialog(sessionFileDialogCallback, this, gui.gpu ? gui.gpu->window : nullptr,
+                             kSessionFileFilters, static_cast<int>(std::size(kSessionFileFilters)),
+                             dir.empty() ? nullptr : dir.c_str(), false);
+    }
+
     drawDBCError(status, popupWidth, palette);
 
     if (drawPopupAction("Close", "\ueb55", "Close", false, popupWidth, palette))
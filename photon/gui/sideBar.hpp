@@ -1,7 +1,11 @@
 #pragma once
+#include <array>
+#include <cstdint>
 #include <mutex>
 #include <string>
 
+#include "../parse/arena.hpp"
+
 struct GUI;
 struct TitleBar;
 struct Canvas;
@@ -16,7 +20,13 @@ struct Sidebar {
   std::string pendingDBCPath{};
   std::string dbcStatus{};
   bool hasPendingDBCPath = false;
+  std::string pendingSessionPath{};
+  bool hasPendingSessionPath = false;
   bool dbcDialogActive = false;
+  // the dbc file picked for each can bus, every picked file is loaded together and an upload
+  // replaces the file of uploadBus
+  std::array<std::string, CAN_BUS_MAX> busFiles{};
+  uint32_t uploadBus{};
 
   void draw(GUI& gui);
   void drawDBCSelector(GUI& gui);
@@ -3,6 +3,7 @@
 #include <errno.h>
 #include <inttypes.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #ifdef _WIN32
@@ -10,6 +11,7 @@
 #else
 #include <arpa/inet.h>
 #include <netinet/in.h>
+#include <sys/socket.h>
 #include <sys/uio.h>
 #include <unistd.h>
 #endif
@@ -34,17 +36,22 @@ static uint64_t canpNtoh64(uint64_t value) {
 #endif
 }
 
-canpPacket_t canpMakePacket(uint32_t canId, uint8_t dlc, const uint8_t data[8],
+/* bus is kept to its two bits, canId loses whatever it had there */
+canpPacket_t canpMakePacket(uint32_t canId, uint32_t bus, uint8_t dlc, const uint8_t data[8],
                             const uint16_t δt[8]) {
   canpPacket_t p;
-  p.can_id = htonl(canId);
+  p.can_id = htonl((canId & ~CANP_BUS_MASK) | ((bus << CANP_BUS_SHIFT) & CANP_BUS_MASK));
   p.dlc = dlc;
   for (int i = 0; i < 8; i++) p.data[i] = data[i];
   for (int i = 0; i < 8; i++) p.δt[i] = htons(δt[i]);
   return p;
 };
 
-uint32_t canpGetId(const canpPacket_t* p) { return ntohl(p->can_id); }
+uint32_t canpGetId(const canpPacket_t* p) { return ntohl(p->can_id) & ~CANP_BUS_MASK; }
+
+uint32_t canpGetBus(const canpPacket_t* p) {
+  return (ntohl(p->can_id) & CANP_BUS_MASK) >> CANP_BUS_SHIFT;
+}
 
 int canpWrite(canpSocket_t fd, struct iovec* iov, int iovcnt) {
   while (iovcnt > 0) {
@@ -127,6 +134,133 @@ int canpReadBatch(canpSocket_t fd, canpBatch_t* batch) {
   return CANP_READ_OK;
 }
 
+int canpStreamInit(canpStream_t* stream, size_t size) {
+  if (size < CANP_HEADER_SIZE + CANP_MAX_BATCH * CANP_PACKET_SIZE) return -1;
+  stream->data = (uint8_t*)malloc(size);
+  stream->size = stream->data ? size : 0;
+  stream->start = 0;
+  stream->end = 0;
+  return stream->data ? 0 : -1;
+}
+
+void canpStreamFree(canpStream_t* stream) {
+  free(stream->data);
+  stream->data = NULL;
+  stream->size = 0;
+  stream->start = 0;
+  stream->end = 0;
+}
+
+static void canpStreamCompact(canpStream_t* stream) {
+  if (stream->start == 0) return;
+  memmove(stream->data, stream->data + stream->start, stream->end - stream->start);
+  stream->end -= stream->start;
+  stream->start = 0;
+}
+
+/* one recv of whatever the socket has, up to the free space after end */
+int canpStreamFill(canpSocket_t fd, canpStream_t* stream) {
+  canpStreamCompact(stream);
+  for (;;) {
+#ifdef _WIN32
+    int n = recv(fd, (char*)stream->data + stream->end, (int)(stream->size - stream->end), 0);
+#else
+    ssize_t n = recv(fd, stream->data + stream->end, stream->size - stream->end, 0);
+#endif
+    if (n == 0) return CANP_READ_CLOSED;
+    if (n < 0) {
+#ifdef _WIN32
+      if (WSAGetLastError() == WSAEINTR) continue;
+#else
+      if (errno == EINTR) continue;
+#endif
+      return CANP_READ_SOCKET_ERROR;
+    }
+    stream->end += (size_t)n;
+    return CANP_READ_OK;
+  }
+}
+
+/* the next complete batch, CANP_READ_MORE leaves a partial one in place */
+int canpStreamNext(canpStream_t* stream, canpBatchView_t* batch) {
+  size_t available = stream->end - stream->start;
+  if (available < sizeof(canpHeader_t)) return CANP_READ_MORE;
+  canpHeader_t hdr;
+  memcpy(&hdr, stream->data + stream->start, sizeof hdr);
+  if (ntohl(hdr.magic) != CANP_MAGIC) return CANP_READ_BAD_MAGIC;
+  if (ntohs(hdr.version) != CANP_VERSION) return CANP_READ_BAD_VERSION;
+  uint16_t n = ntohs(hdr.count);
+  if (n == 0 || n > CANP_MAX_BATCH) return CANP_READ_BAD_COUNT;
+  size_t bytes = sizeof hdr + n * sizeof(canpPacket_t);
+  if (available < bytes) return CANP_READ_MORE;
+  batch->seq = ntohl(hdr.seq);
+  batch->timestamp = canpNtoh64(hdr.timestamp);
+  batch->count = n;
+  batch->packets = (const canpPacket_t*)(stream->data + stream->start + sizeof hdr);
+  stream->start += bytes;
+  return CANP_READ_OK;
+}
+
+#ifndef _WIN32
+/* canpStreamFill for an fd that is not a socket, a serial port or a pipe */
+int canpStreamRead(int fd, canpStream_t* stream) {
+  canpStreamCompact(stream);
+  for (;;) {
+    ssize_t n = read(fd, stream->data + stream->end, stream->size - stream->end);
+    if (n == 0) return CANP_READ_CLOSED;
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      return CANP_READ_SOCKET_ERROR;
+    }
+    stream->end += (size_t)n;
+    return CANP_READ_OK;
+  }
+}
+#endif
+
+static const uint8_t canpMagicBytes[4] = {0x43, 0x41, 0x4E, 0x31};
+
+/* whether the bytes after start could begin a batch, as far as they go */
+static int canpStreamAligned(const canpStream_t* stream) {
+  size_t available = stream->end - stream->start;
+  if (available > sizeof canpMagicBytes) available = sizeof canpMagicBytes;
+  return memcmp(stream->data + stream->start, canpMagicBytes, available) == 0;
+}
+
+/* moves start to the next CANP_MAGIC after it, keeping a partial magic at the end */
+static size_t canpStreamSeek(canpStream_t* stream) {
+  size_t from = stream->start;
+  const uint8_t* at = stream->data + from + 1;
+  const uint8_t* end = stream->data + stream->end;
+  while (at < end) {
+    at = memchr(at, canpMagicBytes[0], (size_t)(end - at));
+    if (!at) break;
+    size_t tail = (size_t)(end - at);
+    if (memcmp(at, canpMagicBytes, tail < 4 ? tail : 4) == 0) {
+      stream->start = (size_t)(at - stream->data);
+      return stream->start - from;
+    }
+    at++;
+  }
+  stream->start = stream->end;
+  return stream->end - from;
+}
+
+/* canpStreamNext for a byte stream that can drop or corrupt bytes, a batch is taken */
+/* only when the next one starts where its count says it ends, anything else is      */
+/* skipped up to the next CANP_MAGIC and counted in skipped                          */
+/* a batch whose tail was lost can still pass while nothing follows it yet           */
+int canpStreamNextSync(canpStream_t* stream, canpBatchView_t* batch, size_t* skipped) {
+  for (;;) {
+    size_t start = stream->start;
+    int r = canpStreamNext(stream, batch);
+    if (r == CANP_READ_MORE) return r;
+    if (r == CANP_READ_OK && canpStreamAligned(stream)) return r;
+    stream->start = start;
+    *skipped += canpStreamSeek(stream);
+  }
+}
+
 int canpRelayBatch(canpSocket_t in_fd, canpSocket_t out_fd) {
   canpBatch_t batch;
   int r = canpReadBatch(in_fd, &batch);
@@ -24,8 +24,15 @@ extern "C" {
 #endif
 
 #define CANP_MAGIC 0x43414E31u /* "CAN1" */
-#define CANP_VERSION 3u
+/* 4 moved the bus into can_id bits 29 and 30, older senders may set them for other uses */
+#define CANP_VERSION 4u
 #define CANP_MAX_BATCH 64u
+/* can_id bit 31 flags a 29 bit extended id, the same encoding dbc files use */
+#define CANP_EXTENDED_FLAG 0x80000000u
+#define CANP_EXTENDED_MASK 0x1FFFFFFFu
+/* bits 29 and 30 carry the bus the frame was seen on, unused by the 29 bit id */
+#define CANP_BUS_SHIFT 29u
+#define CANP_BUS_MASK 0x60000000u
 
 #ifdef _MSC_VER
 #define CANP_PACKED_BEGIN __pragma(pack(push, 1))
@@ -46,7 +53,9 @@ typedef enum {
   CANP_READ_SOCKET_ERROR = -1,
   CANP_READ_BAD_MAGIC = -2,
   CANP_READ_BAD_VERSION = -3,
-  CANP_READ_BAD_COUNT = -4
+  CANP_READ_BAD_COUNT = -4,
+  /* the stream holds no complete batch, fill it again */
+  CANP_READ_MORE = 2
 } canpReadStatus_t;
 
 /* we assume single threaded            */
@@ -83,17 +92,47 @@ typedef struct {
   canpPacket_t packets[CANP_MAX_BATCH];
 } canpBatch_t;
 
+/* a batch parsed in place, packets point into the stream it came from */
+/* and stay valid until that stream is filled again                     */
+typedef struct {
+  uint32_t seq;
+  uint64_t timestamp;
+  uint16_t count;
+  const canpPacket_t* packets;
+} canpBatchView_t;
+
+/* bytes [start, end) of data are received but not yet parsed, a fill   */
+/* moves them to the front first, which is at most one partial batch    */
+#define CANP_STREAM_SIZE (256u * 1024u)
+
+typedef struct {
+  uint8_t* data;
+  size_t size;
+  size_t start;
+  size_t end;
+} canpStream_t;
+
 int canpWrite(canpSocket_t fd, struct iovec* iov, int iovcnt);
 int canpRead(canpSocket_t fd, void* buf, size_t n);
 
 int canpWriteBatch(canpSocket_t fd, canpBatch_t* batch);
 int canpReadBatch(canpSocket_t fd, canpBatch_t* batch);
 
+int canpStreamInit(canpStream_t* stream, size_t size);
+void canpStreamFree(canpStream_t* stream);
+int canpStreamFill(canpSocket_t fd, canpStream_t* stream);
+int canpStreamNext(canpStream_t* stream, canpBatchView_t* batch);
+int canpStreamNextSync(canpStream_t* stream, canpBatchView_t* batch, size_t* skipped);
+#ifndef _WIN32
+int canpStreamRead(int fd, canpStream_t* stream);
+#endif
+
 int canpRelayBatch(canpSocket_t in_fd, canpSocket_t out_fd);
 void canpPrintBatch(canpBatch_t* batch);
 
 uint32_t canpGetId(const canpPacket_t* p);
-canpPacket_t canpMakePacket(uint32_t canId, uint8_t dlc, const uint8_t data[8],
+uint32_t canpGetBus(const canpPacket_t* p);
+canpPacket_t canpMakePacket(uint32_t canId, uint32_t bus, uint8_t dlc, const uint8_t data[8],
                             const uint16_t δt[8]);
 
 #ifdef __cplusplus
@@ -0,0 +1,198 @@
+#include "ingest.hpp"
+
+#ifdef LINUX
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include "../engine/include.hpp"
+
+// ready fds taken per wakeup, more stay ready for the next one
+constexpr int INGEST_EVENTS_MAX = 64;
+// how often every source's link stats are sent, whether or not it received anything
+constexpr timespec INGEST_REPORT_INTERVAL{.tv_sec = 1, .tv_nsec = 0};
+
+bool Ingest::init(Parse& parse, SPMCQueue<ProtocolReceiveVariant, 32>& txBuffer) {
+  this->txBuffer = &txBuffer;
+  pollFd = epoll_create1(EPOLL_CLOEXEC);
+  wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+  // the eventfd and timerfd are the entries without a source
+  epoll_event wakeEvent{.events = EPOLLIN, .data = {.ptr = nullptr}};
+  epoll_event timerEvent{.events = EPOLLIN, .data = {.ptr = &timerFd}};
+  const itimerspec interval{.it_interval = INGEST_REPORT_INTERVAL,
+                            .it_value = INGEST_REPORT_INTERVAL};
+  if (pollFd < 0 || wakeFd < 0 || timerFd < 0 ||
+      epoll_ctl(pollFd, EPOLL_CTL_ADD, wakeFd, &wakeEvent) != 0 ||
+      epoll_ctl(pollFd, EPOLL_CTL_ADD, timerFd, &timerEvent) != 0 ||
+      timerfd_settime(timerFd, 0, &interval, nullptr) != 0) {
+    logs("ingest setup failed: " << std::strerror(errno));
+    destroy();
+    return false;
+  }
+  reader.attach(parse, true);
+  return true;
+}
+
+void Ingest::destroy() {
+  closeAll();
+  reader.detach();
+  if (timerFd >= 0) ::close(timerFd);
+  if (wakeFd >= 0) ::close(wakeFd);
+  if (pollFd >= 0) ::close(pollFd);
+  timerFd = -1;
+  wakeFd = -1;
+  pollFd = -1;
+}
+
+// safe from any thread, a wake before poll makes that poll return at once
+void Ingest::wake() {
+  const uint64_t one = 1;
+  if (wakeFd >= 0) (void)!write(wakeFd, &one, sizeof(one));
+}
+
+// serves ready sources until wake is called
+void Ingest::poll() {
+  if (pollFd < 0) return;
+  std::array<epoll_event, INGEST_EVENTS_MAX> events{};
+  for (;;) {
+    const int count = epoll_wait(pollFd, events.data(), INGEST_EVENTS_MAX, -1);
+    if (count < 0) {
+      if (errno == EINTR) continue;
+      return;
+    }
+
+    bool woken = false;
+    Arena* arena = reader.lock();
+    if (arena && arena->generation != generation) filter(*arena);
+    for (int i = 0; i < count; i++) {
+      if (events[i].data.ptr == &timerFd) {
+        uint64_t expirations = 0;
+        (void)!read(timerFd, &expirations, sizeof(expirations));
+        report();
+        continue;
+      }
+      auto* source = static_cast<IngestSource*>(events[i].data.ptr);
+      if (!source) {
+        uint64_t value = 0;
+        (void)!read(wakeFd, &value, sizeof(value));
+        woken = true;
+        continue;
+      }
+
+      const uint32_t wanted = source->events;
+      bool open = false;
+      if (std::holds_alternative<TCPSource>(source->state))
+        open = Protocols::stepTCP(*source, arena, *txBuffer);
+      else if (std::holds_alternative<UDPSource>(source->state))
+        open = Protocols::stepUDP(*source, arena, *txBuffer);
+      else if (std::holds_alternative<CANSource>(source->state))
+        open = Protocols::stepCAN(*source, arena, *txBuffer);
+      else if (std::holds_alternative<UARTSource>(source->state))
+        open = Protocols::stepUART(*source, arena, *txBuffer);
+      if (!open) {
+        remove(*source);
+        continue;
+      }
+      if (source->events == wanted) continue;
+      epoll_event event{.events = source->events, .data = {.ptr = source}};
+      epoll_ctl(pollFd, EPOLL_CTL_MOD, source->fd, &event);
+    }
+    reader.unlock();
+    if (woken) return;
+  }
+}
+
+void Ingest::publishError(const std::string& error) {
+  txBuffer->write([&](ProtocolReceiveVariant& out) { out = ProtocolError{.error = error}; });
+}
+
+// a source opened again under the same name replaces the old one
+void Ingest::open(const TCPConfig& config) {
+  auto source = std::make_unique<IngestSource>();
+  source->name = "TCP " + std::string(config.ip) + ":" + std::to_string(config.port);
+  close(source->name);
+  std::string error{};
+  if (!Protocols::openTCP(*source, config, error)) return publishError(error);
+  add(std::move(source));
+}
+
+void Ingest::open(const UDPConfig& config) {
+  auto source = std::make_unique<IngestSource>();
+  source->name = "UDP " + std::string(config.ip) + ":" + std::to_string(config.port);
+  close(source->name);
+  std::string error{};
+  if (!Protocols::openUDP(*source, config, error)) return publishError(error);
+  add(std::move(source));
+}
+
+// the kernel filters are set before the first frame is read, and again on every dbc change
+void Ingest::open(const PCANConfig& config) {
+  auto source = std::make_unique<IngestSource>();
+  source->name = "CAN " + std::string(config.channel);
+  close(source->name);
+  std::string error{};
+  if (!Protocols::openCAN(*source, config, error)) return publishError(error);
+  IngestSource& opened = *source;
+  add(std::move(source));
+  if (sources.empty() || sources.back().get() != &opened) return;
+  if (const Arena* arena = reader.lock()) Protocols::filterCAN(opened, *arena);
+  reader.unlock();
+}
+
+void Ingest::open(const UARTConfig& config) {
+  auto source = std::make_unique<IngestSource>();
+  source->name = "UART " + std::string(config.device);
+  close(source->name);
+  std::string error{};
+  if (!Protocols::openUART(*source, config, error)) return publishError(error);
+  add(std::move(source));
+}
+
+void Ingest::filter(const Arena& arena) {
+  generation = arena.generation;
+  for (auto& source : sources)
+    if (std::holds_alternative<CANSource>(source->state)) Protocols::filterCAN(*source, arena);
+}
+
+void Ingest::report() {
+  for (auto& source : sources) Protocols::reportLink(*source, *txBuffer);
+}
+
+void Ingest::add(std::unique_ptr<IngestSource> source) {
+  epoll_event event{.events = source->events, .data = {.ptr = source.get()}};
+  const bool polled = epoll_ctl(pollFd, EPOLL_CTL_ADD, source->fd, &event) == 0;
+  sources.push_back(std::move(source));
+  if (polled) return;
+  publishError(sources.back()->name + " poll failed: " + std::strerror(errno));
+  remove(*sources.back());
+}
+
+void Ingest::close(const std::string& name) {
+  for (auto& source : sources)
+    if (source->name == name) return remove(*source);
+}
+
+void Ingest::closeAll() {
+  while (!sources.empty()) remove(*sources.back());
+}
+
+void Ingest::remove(IngestSource& source) {
+  epoll_ctl(pollFd, EPOLL_CTL_DEL, source.fd, nullptr);
+  if (std::holds_alternative<TCPSource>(source.state))
+    Protocols::closeTCP(source, *txBuffer);
+  else if (std::holds_alternative<UDPSource>(source.state))
+    Protocols::closeUDP(source, *txBuffer);
+  else if (std::holds_alternative<CANSource>(source.state))
+    Protocols::closeCAN(source, *txBuffer);
+  else if (std::holds_alternative<UARTSource>(source.state))
+    Protocols::closeUART(source, *txBuffer);
+  std::erase_if(sources, [&](const auto& open) { return open.get() == &source; });
+}
+#endif
@@ -0,0 +1,121 @@
+#pragma once
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "../parse/parse.hpp"
+#include "../parse/spmc.hpp"
+#include "canp.h"
+#include "protocols.hpp"
+
+#ifdef LINUX
+#include <linux/can.h>
+
+// a CANP stream over TCP, connecting until the socket first reports writable
+struct TCPSource {
+  TCPConfig config{};
+  canpStream_t stream{};
+  bool connected{};
+};
+
+// datagrams taken per recvmmsg and the largest one kept whole, a datagram may carry
+// several CANP batches back to back
+constexpr uint32_t UDP_RECV_BATCH = 64;
+constexpr uint32_t UDP_DATAGRAM_MAX = 4096;
+// batches a late one may trail the newest by before the sender is taken to have restarted
+constexpr int32_t UDP_REORDER_WINDOW = 1024;
+
+// what a source has received, sent back once a second while it is open
+struct LinkCounters {
+  ProtocolLinkStats stats{};
+  uint64_t reportedFrames{};
+  std::chrono::steady_clock::time_point reported{};
+};
+
+// CANP batches over UDP, the server is sent config.subscribeMessage once on open
+// nextSeq is one past the newest seq seen, anything older arrived late
+// missing marks the seqs of the last UDP_REORDER_WINDOW that were skipped, bit seq % window
+struct UDPSource {
+  UDPConfig config{};
+  std::vector<uint8_t> buffer{};
+  bool sequenced{};
+  uint32_t nextSeq{};
+  std::bitset<UDP_REORDER_WINDOW> missing{};
+  LinkCounters link{};
+};
+
+// frames taken per recvmmsg, one FrameBatch worth, and the ancillary data kept per frame,
+// room for the three timestamps of SO_TIMESTAMPING and the SO_RXQ_OVFL drop count
+constexpr uint32_t CAN_RECV_BATCH = CANP_MAX_BATCH;
+constexpr size_t CAN_CONTROL_BYTES = 128;
+
+// a SocketCAN interface read directly, every frame belongs to dbc bus config.bus
+// the kernel only passes ids the arena of generation filtered knows, see Protocols::filterCAN
+// control holds one receive timestamp and drop count per frame
+struct CANSource {
+  PCANConfig config{};
+  std::vector<can_frame> frames{};
+  std::vector<uint8_t> control{};
+  uint64_t filtered = UINT64_MAX;
+  LinkCounters link{};
+};
+
+// a seq jump further than this is the sender restarting rather than batches lost
+constexpr int32_t UART_RESTART_GAP = 1024;
+
+// a CANP stream over a serial port, resynchronized on CANP_MAGIC when bytes are lost
+// nextSeq is one past the newest seq seen, a gap after it is batches that never framed
+struct UARTSource {
+  UARTConfig config{};
+  canpStream_t stream{};
+  bool sequenced{};
+  uint32_t nextSeq{};
+  uint64_t skipped{};
+  LinkCounters link{};
+};
+
+// one fd the ingest loop waits on, events is the epoll interest the protocol wants next
+struct IngestSource {
+  int fd = -1;
+  uint32_t events{};
+  std::string name{};
+  std::variant<TCPSource, UDPSource, CANSource, UARTSource> state{};
+};
+
+// every source on one thread, an epoll set of their fds plus an eventfd that commands and
+// stop requests ring, see Network::backend, and a timerfd that reports link stats
+// each wakeup pins the arena once for every source that is ready
+struct Ingest {
+  int pollFd = -1;
+  int wakeFd = -1;
+  int timerFd = -1;
+  SPMCQueue<ProtocolReceiveVariant, 32>* txBuffer{};
+  std::vector<std::unique_ptr<IngestSource>> sources{};
+  ArenaReader reader{};
+  // the arena generation sources were last filtered for
+  uint64_t generation = UINT64_MAX;
+
+  bool init(Parse& parse, SPMCQueue<ProtocolReceiveVariant, 32>& txBuffer);
+  void destroy();
+  void wake();
+  void poll();
+  void open(const TCPConfig& config);
+  void open(const UDPConfig& config);
+  void open(const PCANConfig& config);
+  void open(const UARTConfig& config);
+  void close(const std::string& name);
+  void closeAll();
+
+ private:
+  void add(std::unique_ptr<IngestSource> source);
+  void remove(IngestSource& source);
+  void publishError(const std::string& error);
+  void filter(const Arena& arena);
+  void report();
+};
+
+#endif
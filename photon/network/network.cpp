@@ -9,22 +9,41 @@
 #include "protocols.hpp"
 
 void Network::init() {
+#ifdef LINUX
+  ingest.init(*parse, guiTxCommandBuffer);
+#endif
   backendThread = std::jthread([this](std::stop_token stoken) { backend(stoken); });
 };
 
+// the gui's way in, the backend is woken rather than polling for it
+void Network::submit(const ProtocolTransmitVariant& command) {
+  guiRxCommandBuffer.write([&](ProtocolTransmitVariant& cmd) { cmd = command; });
+#ifdef LINUX
+  ingest.wake();
+#endif
+}
+
 void Network::startTCP(TCPConfig config) {
+#ifdef LINUX
+  ingest.open(config);
+#else
   std::lock_guard lock(writerMutex);
   stopWriterUnlocked();
   activeTCPConfig = config;
   writerThread = std::jthread([this, config](std::stop_token stoken) {
-    Protocols::TCP(stoken, guiTxCommandBuffer, config, parse->arena);
+    Protocols::TCP(stoken, guiTxCommandBuffer, config, *parse);
   });
+#endif
 }
 
 void Network::stopWriter() {
+#ifdef LINUX
+  ingest.closeAll();
+#else
   std::lock_guard lock(writerMutex);
   stopWriterUnlocked();
   activeTCPConfig.reset();
+#endif
 }
 
 void Network::stopWriterUnlocked() {
@@ -33,34 +52,54 @@ void Network::stopWriterUnlocked() {
   writerThread.join();
 }
 
-void Network::restartWriterUnlocked() {
-  if (!activeTCPConfig || !parse) return;
-  const TCPConfig config = *activeTCPConfig;
-  writerThread = std::jthread([this, config](std::stop_token stoken) {
-    Protocols::TCP(stoken, guiTxCommandBuffer, config, parse->arena);
-  });
+// the new arena is published under the running writer, which picks it up on its next batch
+// the ingest loop is woken so can sources refilter for it even while no frames arrive
+bool Network::switchDBC(DBCType kind) {
+  if (!parse || !parse->loadDBC(kind)) return false;
+#ifdef LINUX
+  ingest.wake();
+#endif
+  return true;
 }
 
-bool Network::switchDBC(DBCType kind) {
-  std::lock_guard lock(writerMutex);
-  const bool shouldRestart = writerThread.joinable() && activeTCPConfig.has_value();
-  stopWriterUnlocked();
-  const bool loaded = parse && parse->loadDBC(kind);
-  if (shouldRestart) restartWriterUnlocked();
-  return loaded;
+bool Network::switchDBCFiles(std::span<const BusFile> files) {
+  if (!parse || !parse->loadDBCFiles(files)) return false;
+#ifdef LINUX
+  ingest.wake();
+#endif
+  return true;
 }
 
-bool Network::switchDBCFile(const std::string& path) {
-  std::lock_guard lock(writerMutex);
-  const bool shouldRestart = writerThread.joinable() && activeTCPConfig.has_value();
-  stopWriterUnlocked();
-  const bool loaded = parse && parse->loadDBCFile(path);
-  if (shouldRestart) restartWriterUnlocked();
-  return loaded;
+// the recorded frames come back with the dbcs they were recorded against
+bool Network::openSession(const std::string& path) {
+  if (!parse || !parse->openSession(path)) return false;
+#ifdef LINUX
+  ingest.wake();
+#endif
+  return true;
 }
 
 void Network::backend(std::stop_token stoken) {
   auto reader = guiRxCommandBuffer.getReader();
+#ifdef LINUX
+  // every command is handled in order, then the sources are served until the next one
+  std::stop_callback wakeOnStop(stoken, [this] { ingest.wake(); });
+  while (!stoken.stop_requested()) {
+    while (ProtocolTransmitVariant* cmd = reader.read()) {
+      if (auto* tcp = std::get_if<TCPConfig>(cmd)) {
+        startTCP(*tcp);
+      } else if (auto* udp = std::get_if<UDPConfig>(cmd)) {
+        ingest.open(*udp);
+      } else if (auto* pcan = std::get_if<PCANConfig>(cmd)) {
+        ingest.open(*pcan);
+      } else if (auto* uart = std::get_if<UARTConfig>(cmd)) {
+        ingest.open(*uart);
+      } else if (std::get_if<Quit>(cmd))
+        stopWriter();
+    }
+    ingest.poll();
+  }
+#else
   while (!stoken.stop_requested()) {
     auto cmd = reader.readLast();
     if (cmd != NULL) {
@@ -77,6 +116,7 @@ void Network::backend(std::stop_token stoken) {
       std::this_thread::sleep_for(std::chrono::milliseconds(10));
     };
   };
+#endif
   stopWriter();
 };
 
@@ -85,4 +125,7 @@ void Network::destroy() {
     backendThread.request_stop();
     backendThread.join();
   }
+#ifdef LINUX
+  ingest.destroy();
+#endif
 };
@@ -1,6 +1,7 @@
 #pragma once
 #include <mutex>
 #include <optional>
+#include <span>
 #include <stop_token>
 #include <string>
 #include <thread>
@@ -8,18 +9,25 @@
 
 #include "../parse/parse.hpp"
 #include "../parse/spmc.hpp"
+#include "ingest.hpp"
 #include "protocols.hpp"
 
 struct Network {
   void init();
   void destroy();
   void backend(std::stop_token stoken);
+  void submit(const ProtocolTransmitVariant& command);
   void startTCP(TCPConfig config);
   void stopWriter();
   bool switchDBC(DBCType kind);
-  bool switchDBCFile(const std::string& path);
+  bool switchDBCFiles(std::span<const BusFile> files);
+  bool openSession(const std::string& path);
   Parse* parse;
 
+#ifdef LINUX
+  // every source runs on the backend thread, see Ingest
+  Ingest ingest{};
+#endif
   std::jthread backendThread{};
   std::jthread writerThread{};
   std::mutex writerMutex{};
@@ -37,5 +45,4 @@ struct Network {
 
  private:
   void stopWriterUnlocked();
-  void restartWriterUnlocked();
 };
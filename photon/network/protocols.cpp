@@ -10,9 +10,13 @@
 #include <format>
 #include <string>
 #include <thread>
+#include <tracy/Tracy.hpp>
 
 #include "../parse/arena.hpp"
+#include "../parse/batch.hpp"
+#include "../parse/decode.hpp"
 #include "canp.h"
+#include "ingest.hpp"
 
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
@@ -22,8 +26,14 @@ using SocketHandle = SOCKET;
 #else
 #include <arpa/inet.h>
 #include <fcntl.h>
+#include <linux/can/raw.h>
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
+#include <net/if.h>
+#include <sys/epoll.h>
 #include <sys/select.h>
 #include <sys/socket.h>
+#include <termios.h>
 #include <unistd.h>
 using SocketHandle = int;
 #define INVALID_SOCKET (-1)
@@ -202,8 +212,9 @@ bool finishTcpConnect(SocketHandle& sock, std::string& error) {
   return false;
 }
 
-bool connectTcp(SocketHandle& sock, const TCPConfig& config, std::stop_token stoken,
-                std::string& error) {
+// a non-blocking socket with its connect started, true once it is connected or in progress
+bool startTcpConnect(SocketHandle& sock, const TCPConfig& config, bool& connected,
+                     std::string& error) {
 #ifdef _WIN32
   if (!ensureWinsock(error)) return false;
 #endif
@@ -231,15 +242,20 @@ bool connectTcp(SocketHandle& sock, const TCPConfig& config, std::stop_token sto
     return false;
   }
 
-  if (connect(sock, reinterpret_cast<const sockaddr*>(&server), sizeof(server)) == 0)
-    return finishTcpConnect(sock, error);
-  if (!wouldBlock()) {
-    error = socketError("TCP connect");
-    closeSocket(sock);
-    sock = INVALID_SOCKET;
-    return false;
-  }
+  connected = connect(sock, reinterpret_cast<const sockaddr*>(&server), sizeof(server)) == 0;
+  if (connected || wouldBlock()) return true;
 
+  error = socketError("TCP connect");
+  closeSocket(sock);
+  sock = INVALID_SOCKET;
+  return false;
+}
+
+bool connectTcp(SocketHandle& sock, const TCPConfig& config, std::stop_token stoken,
+                std::string& error) {
+  bool connected = false;
+  if (!startTcpConnect(sock, config, connected, error)) return false;
+  if (connected) return finishTcpConnect(sock, error);
   if (waitForConnect(sock, stoken, error)) return finishTcpConnect(sock, error);
 
   closeSocket(sock);
@@ -247,96 +263,101 @@ bool connectTcp(SocketHandle& sock, const TCPConfig& config, std::stop_token sto
   return false;
 }
 
-bool extractSignalRaw(const uint8_t data[8], uint8_t dlc, const Signal& sig, uint64_t& raw) {
-  raw = 0;
-  if (sig.startBit < 0 || sig.length <= 0 || sig.length > 64 || dlc > 8) return false;
+double batchTimeSeconds(uint64_t timestampMs) { return static_cast<double>(timestampMs) / 1000.0; }
 
-  const int availableBits = static_cast<int>(dlc) * 8;
-  if (sig.endianness == 1) {
-    if (sig.startBit + sig.length > availableBits) return false;
-    for (int i = 0; i < sig.length; i++) {
-      const int bit = sig.startBit + i;
-      raw |= static_cast<uint64_t>((data[bit / 8] >> (bit % 8)) & 0x1u) << i;
-    }
-    return true;
-  }
+// frames of one message or mux group within a batch, by packet index
+struct DecodeGroup {
+  Message* msg{};
+  uint32_t count{};
+  uint16_t rows[CANP_MAX_BATCH]{};
+};
 
-  int bit = sig.startBit;
-  for (int i = 0; i < sig.length; i++) {
-    if (bit < 0 || bit >= availableBits) return false;
-    raw = (raw << 1) | static_cast<uint64_t>((data[bit / 8] >> (bit % 8)) & 0x1u);
-    bit = (bit % 8 == 0) ? bit + 15 : bit - 1;
+// a multiplexed frame lands in its message and in the group of its multiplexor value
+constexpr uint32_t DECODE_GROUP_MAX = CANP_MAX_BATCH * 2;
+
+void addRow(std::array<DecodeGroup, DECODE_GROUP_MAX>& groups, uint32_t& groupCount, Message* msg,
+            uint16_t row) {
+  uint32_t g = 0;
+  while (g < groupCount && groups[g].msg != msg) g++;
+  if (g == groupCount) {
+    groups[g].msg = msg;
+    groups[g].count = 0;
+    groupCount++;
   }
-  return true;
+  groups[g].rows[groups[g].count++] = row;
 }
 
-int64_t signExtend(uint64_t raw, int bits) {
-  if (bits <= 0 || bits >= 64) return static_cast<int64_t>(raw);
-
-  const uint64_t signBit = uint64_t{1} << (bits - 1);
-  const uint64_t mask = (uint64_t{1} << bits) - 1;
-  raw &= mask;
-  if ((raw & signBit) != 0) raw |= ~mask;
-  return static_cast<int64_t>(raw);
-}
+static_assert(CANP_MAX_BATCH <= DECODE_LANES_MAX);
+
+// up to CANP_MAX_BATCH frames as they were received, frame i's 8 payload bytes are at
+// payload + i * stride so decode lanes gather straight from the receive buffer
+struct FrameBatch {
+  const uint8_t* payload{};
+  size_t stride{};
+  uint16_t count{};
+  std::array<uint32_t, CANP_MAX_BATCH> keys;
+  std::array<uint8_t, CANP_MAX_BATCH> dlcs;
+  std::array<double, CANP_MAX_BATCH> times;
+};
 
-bool decodeSignalValue(const canpPacket_t& packet, const Signal& sig, double& value) {
-  uint64_t raw = 0;
-  if (!extractSignalRaw(packet.data, packet.dlc, sig, raw)) return false;
+void ingestFrames(const FrameBatch& frames, Arena& arena) {
+  ZoneScopedN("ingestFrames");
+  std::array<DecodeGroup, DECODE_GROUP_MAX> groups;
+  uint32_t groupCount = 0;
+  for (uint16_t i = 0; i < frames.count; i++) {
+    const uint8_t dlc = frames.dlcs[i];
+    if (dlc > 8) continue;
+
+    Message* msg = arena.message(frames.keys[i]);
+    if (!msg || !msg->decodable || msg->signalCount > SIGNAL_MAX) continue;
+    if (dlc < msg->minDlc) continue;
+    addRow(groups, groupCount, msg, i);
+
+    // only the signals of the value on the wire are decoded, the rest are not in this frame
+    if (!msg->muxCount) continue;
+    const uint64_t word = loadPayload(frames.payload + i * frames.stride);
+    const uint64_t value =
+        decodeRaw(msg->signals[msg->muxSignal]->plan, word, std::byteswap(word));
+    Message* group = value <= UINT32_MAX ? msg->muxGroup(static_cast<uint32_t>(value)) : nullptr;
+    if (!group || !group->decodable || dlc < group->minDlc) continue;
+    addRow(groups, groupCount, group, i);
+  }
 
-  switch (sig.type) {
-    case vFLOAT: {
-      if (sig.length != 32) return false;
-      const auto bits = static_cast<uint32_t>(raw);
-      value = static_cast<double>(std::bit_cast<float>(bits)) * sig.scale + sig.offset;
-      return true;
-    }
-    case vDOUBLE: {
-      if (sig.length != 64) return false;
-      value = std::bit_cast<double>(raw) * sig.scale + sig.offset;
-      return true;
-    }
-    case vINT:
-    default: {
-      const double parsed = sig.isSigned ? static_cast<double>(signExtend(raw, sig.length))
-                                         : static_cast<double>(raw);
-      value = parsed * sig.scale + sig.offset;
-      return true;
-    }
+  DecodeLanes lanes;
+  std::array<double, CANP_MAX_BATCH> times;
+  alignas(32) std::array<double, SIGNAL_MAX * CANP_MAX_BATCH> columns;
+  for (uint32_t g = 0; g < groupCount; g++) {
+    const DecodeGroup& group = groups[g];
+    Message& msg = *group.msg;
+    gatherLanes(frames.payload, frames.stride, group.rows, group.count, lanes);
+    for (uint32_t j = 0; j < group.count; j++) times[j] = frames.times[group.rows[j]];
+    // raw and typed messages keep the undecoded fields and are decoded by whoever reads them
+    const bool payloads = msg.payloadData || msg.typed;
+    if (!payloads) decodeMessageLanes(msg, lanes, columns.data(), CANP_MAX_BATCH);
+
+    auto append = [&] {
+      if (payloads) return arena.appendPayloads(msg, times.data(), lanes.words, group.count);
+      return arena.appendFrames(msg, times.data(), columns.data(), CANP_MAX_BATCH, group.count);
+    };
+    // a full linear arena starts over, unless another source is mid-append to the message
+    if (!append() && arena.clear(msg)) append();
   }
 }
 
-double batchTimeSeconds(uint64_t timestampMs) { return static_cast<double>(timestampMs) / 1000.0; }
-
-void handleNetwork(const canpBatch_t& batch, Arena& arena) {
-  double timeValue = batchTimeSeconds(batch.timestamp);
-  const uint16_t count = batch.count > CANP_MAX_BATCH ? CANP_MAX_BATCH : batch.count;
-  for (uint16_t i = 0; i < count; i++) {
+// every frame of a CANP batch shares the batch's time
+void handleNetwork(const canpBatchView_t& batch, Arena& arena) {
+  ZoneScopedN("handleNetwork");
+  FrameBatch frames;
+  frames.payload = reinterpret_cast<const uint8_t*>(batch.packets[0].data);
+  frames.stride = sizeof(canpPacket_t);
+  frames.count = batch.count > CANP_MAX_BATCH ? CANP_MAX_BATCH : batch.count;
+  frames.times.fill(batchTimeSeconds(batch.timestamp));
+  for (uint16_t i = 0; i < frames.count; i++) {
     const canpPacket_t& packet = batch.packets[i];
-    if (packet.dlc > 8) continue;
-
-    const uint32_t id = canpGetId(&packet);
-    if (id >= arena.messages.size()) continue;
-
-    Message* msg = arena.messages[id];
-    if (!msg || msg->signalCount == 0 || msg->signalCount > SIGNAL_MAX) continue;
-
-    std::array<double, SIGNAL_MAX> values{};
-    bool decoded = true;
-    for (uint32_t signalIndex = 0; signalIndex < msg->signalCount; signalIndex++) {
-      Signal* sig = msg->signals[signalIndex];
-      if (!sig || !decodeSignalValue(packet, *sig, values[signalIndex])) {
-        decoded = false;
-        break;
-      }
-    }
-    if (!decoded) continue;
-
-    if (!arena.appendFrame(id, timeValue, values.data(), msg->signalCount)) {
-      arena.clear(id);
-      arena.appendFrame(id, timeValue, values.data(), msg->signalCount);
-    }
+    frames.keys[i] = messageKey(canpGetBus(&packet), canpGetId(&packet));
+    frames.dlcs[i] = packet.dlc;
   }
+  ingestFrames(frames, arena);
 }
 
 std::string timeNow() {
@@ -346,8 +367,18 @@ std::string timeNow() {
   return "[" + std::format("{:%H:%M:%S}.{:03}", seconds, ms.count()) + "]  ";
 };
 
+// why a CANP stream stopped, for any status but CANP_READ_OK and CANP_READ_MORE
+void publishStreamEnd(SPMCQueue<ProtocolReceiveVariant, 32>& txBuffer, int readStatus) {
+  if (readStatus == CANP_READ_CLOSED)
+    publishMessage(txBuffer, timeNow() + "TCP peer closed connection");
+  else if (readStatus == CANP_READ_SOCKET_ERROR)
+    publishError(txBuffer, socketError("TCP recv"));
+  else
+    publishError(txBuffer, timeNow() + canpReadError(readStatus));
+}
+
 void Protocols::TCP(std::stop_token stoken, SPMCQueue<ProtocolReceiveVariant, 32>& txBuffer,
-                    TCPConfig config, Arena& arena) {
+                    TCPConfig config, Parse& parse) {
   SocketHandle sock = INVALID_SOCKET;
   std::string error{};
   if (!connectTcp(sock, config, stoken, error)) {
@@ -356,7 +387,19 @@ void Protocols::TCP(std::stop_token stoken, SPMCQueue<ProtocolReceiveVariant, 32
   }
   publishMessage(txBuffer, timeNow() + "TCP connected");
 
-  canpBatch_t batch{};
+  canpStream_t stream{};
+  if (canpStreamInit(&stream, CANP_STREAM_SIZE) != 0) {
+    publishError(txBuffer, timeNow() + "CANP stream allocation failed");
+    closeSocket(sock);
+    return;
+  }
+
+  // the arena is pinned per fill so a dbc swap lands between fills
+  // every complete batch in a fill is decoded where it was received, one recv can carry
+  // thousands of frames of a burst
+  ArenaReader reader{};
+  reader.attach(parse, true);
+  canpBatchView_t batch{};
   while (!stoken.stop_requested()) {
     std::string waitError{};
     const SocketWaitResult waitResult = waitForReadable(sock, stoken, waitError);
@@ -366,22 +409,477 @@ void Protocols::TCP(std::stop_token stoken, SPMCQueue<ProtocolReceiveVariant, 32
       break;
     }
 
-    int readStatus = canpReadBatch(sock, &batch);
+    int readStatus = canpStreamFill(sock, &stream);
     if (readStatus == CANP_READ_OK) {
-      handleNetwork(batch, arena);
-      continue;
+      Arena* arena = reader.lock();
+      while ((readStatus = canpStreamNext(&stream, &batch)) == CANP_READ_OK)
+        if (arena) handleNetwork(batch, *arena);
+      reader.unlock();
+      if (readStatus == CANP_READ_MORE) continue;
     }
-    if (readStatus == CANP_READ_CLOSED) {
-      publishMessage(txBuffer, timeNow() + "TCP peer closed connection");
-      break;
-    }
-    if (readStatus == CANP_READ_SOCKET_ERROR) {
-      publishError(txBuffer, socketError("TCP recv"));
-      break;
-    }
-    publishError(txBuffer, timeNow() + canpReadError(readStatus));
+    publishStreamEnd(txBuffer, readStatus);
     break;
   }
+  reader.detach();
+  canpStreamFree(&stream);
   closeSocket(sock);
   publishMessage(txBuffer, timeNow() + "TCP stopped");
 }
+
+#ifdef LINUX
+// even a connect that finished at once is reported from the first writable wakeup
+bool Protocols::openTCP(IngestSource& source, const TCPConfig& config, std::string& error) {
+  TCPSource tcp{.config = config};
+  SocketHandle sock = INVALID_SOCKET;
+  bool connected = false;
+  if (!startTcpConnect(sock, config, connected, error)) return false;
+  if (canpStreamInit(&tcp.stream, CANP_STREAM_SIZE) != 0) {
+    error = "CANP stream allocation failed";
+    closeSocket(sock);
+    return false;
+  }
+  source.fd = sock;
+  source.events = EPOLLOUT;
+  source.state = tcp;
+  return true;
+}
+
+// one recv per wakeup, the socket stays non-blocking so a spurious one costs nothing
+bool Protocols::stepTCP(IngestSource& source, Arena* arena,
+                        SPMCQueue<ProtocolReceiveVariant, 32>& txBuffer) {
+  TCPSource& tcp = std::get<TCPSource>(source.state);
+  if (!tcp.connected) {
+    int connectError = 0;
+    socklen_t connectErrorSize = sizeof(connectError);
+    if (getsockopt(source.fd, SOL_SOCKET, SO_ERROR, &connectError, &connectErrorSize) ==
+        SOCKET_ERROR) {
+      publishError(txBuffer, socketError("TCP connect status"));
+      return false;
+    }
+    if (connectError != 0) {
+      publishError(txBuffer, socketError("TCP connect", connectError));
+      return false;
+    }
+    tcp.connected = true;
+    source.events = EPOLLIN;
+    publishMessage(txBuffer, timeNow() + "TCP connected");
+    return true;
+  }
+
+  int readStatus = canpStreamFill(source.fd, &tcp.stream);
+  if (readStatus == CANP_READ_SOCKET_ERROR && wouldBlock()) return true;
+  if (readStatus == CANP_READ_OK) {
+    canpBatchView_t batch{};
+    while ((readStatus = canpStreamNext(&tcp.stream, &batch)) == CANP_READ_OK)
+      if (arena) handleNetwork(batch, *arena);
+    if (readStatus == CANP_READ_MORE) return true;
+  }
+  publishStreamEnd(txBuffer, readStatus);
+  return false;
+}
+
+void Protocols::closeTCP(IngestSource& source, SPMCQueue<ProtocolReceiveVariant, 32>& txBuffer) {
+  canpStreamFree(&std::get<TCPSource>(source.state).stream);
+  closeSocket(source.fd);
+  source.fd = INVALID_SOCKET;
+  publishMessage(txBuffer, timeNow() + "TCP stopped");
+}
+
+bool Protocols::openUDP(IngestSource& source, const UDPConfig& config, std::string& error) {
+  SocketHandle sock = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (sock == INVALID_SOCKET) {
+    error = socketError("UDP socket creation");
+    return false;
+  }
+  // room for a burst to wait out the other sources, the kernel may clamp it
+  const int receiveBuffer = 4 << 20;
+  setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+
+  // connected, so only the server's datagrams arrive and the subscription needs no address
+  sockaddr_in server{};
+  server.sin_family = AF_INET;
+  server.sin_port = htons(config.port);
+  if (inet_pton(AF_INET, config.ip, &server.sin_addr) != 1) {
+    error = "invalid UDP IP address: " + std::string(config.ip);
+    closeSocket(sock);
+    return false;
+  }
+  if (connect(sock, reinterpret_cast<const sockaddr*>(&server), sizeof(server)) != 0) {
+    error = socketError("UDP connect");
+    closeSocket(sock);
+    return false;
+  }
+  const size_t subscribeLength = strnlen(config.subscribeMessage, sizeof(config.subscribeMessage));
+  if (subscribeLength && send(sock, config.subscribeMessage, subscribeLength, 0) < 0) {
+    error = socketError("UDP subscribe");
+    closeSocket(sock);
+    return false;
+  }
+
+  UDPSource udp{.config = config};
+  udp.buffer.resize(static_cast<size_t>(UDP_RECV_BATCH) * UDP_DATAGRAM_MAX);
+  udp.link.stats.source = "UDP " + std::string(config.ip) + ":" + std::to_string(config.port);
+  udp.link.reported = std::chrono::steady_clock::now();
+  source.fd = sock;
+  source.events = EPOLLIN;
+  source.state = std::move(udp);
+  return true;
+}
+
+// a batch ahead of nextSeq means the ones between were lost and are marked missing, one
+// behind it that is still marked turned up late, anything else behind it is a duplicate
+// one far behind means the sender restarted its count, which starts over from it
+// returns whether the batch is new, late ones would land behind frames already appended
+bool countSequence(UDPSource& udp, uint32_t seq) {
+  if (!udp.sequenced || static_cast<int32_t>(udp.nextSeq - seq) > UDP_REORDER_WINDOW) {
+    udp.sequenced = true;
+    udp.missing.reset();
+    udp.nextSeq = seq + 1;
+    return true;
+  }
+  const auto ahead = static_cast<int32_t>(seq - udp.nextSeq);
+  if (ahead >= 0) {
+    udp.link.stats.lost += static_cast<uint32_t>(ahead);
+    if (ahead >= UDP_REORDER_WINDOW) udp.missing.reset();
+    for (int32_t back = std::min(ahead, UDP_REORDER_WINDOW - 1); back > 0; back--)
+      udp.missing.set((seq - static_cast<uint32_t>(back)) % UDP_REORDER_WINDOW);
+    udp.missing.reset(seq % UDP_REORDER_WINDOW);
+    udp.nextSeq = seq + 1;
+    return true;
+  }
+  if (!udp.missing.test(seq % UDP_REORDER_WINDOW)) return false;
+  udp.missing.reset(seq % UDP_REORDER_WINDOW);
+  udp.link.stats.reordered++;
+  udp.link.stats.lost--;
+  return false;
+}
+
+void publishLinkStats(SPMCQueue<ProtocolReceiveVariant, 32>& txBuffer, LinkCounters& link,
+                      std::chrono::steady_clock::time_point now) {
+  const double seconds = std::chrono::duration<double>(now - link.reported).count();
+  const auto frames = static_cast<double>(link.stats.frames - link.reportedFrames);
+  link.stats.framesPerSecond = seconds > 0.0 ? frames / seconds : 0.0;
+  link.reportedFrames = link.stats.frames;
+  link.reported = now;
+  txBuffer.write([&](ProtocolReceiveVariant& out) { out = link.stats; });
+}
+
+// sent on the ingest loop's one second tick rather than from step, so a link that went
+// quiet reports 0 frames/s instead of its last busy second
+void Protocols::reportLink(IngestSource& source, SPMCQueue<ProtocolReceiveVariant, 32>& txBuffer) {
+  const auto now = std::chrono::steady_clock::now();
+  if (auto* udp = std::get_if<UDPSource>(&source.state))
+    publishLinkStats(txBuffer, udp->link, now);
+  else if (auto* can = std::get_if<CANSource>(&source.state))
+    publishLinkStats(txBuffer, can->link, now);
+  else if (auto* uart = std::get_if<UARTSource>(&source.state))
+    publishLinkStats(txBuffer, uart->link, now);
+}
+
+// drains up to UDP_RECV_BATCH datagrams per wakeup, epoll wakes again while more wait
+bool Protocols::stepUDP(IngestSource& source, Arena* arena,
+                        SPMCQueue<ProtocolReceiveVariant, 32>& txBuffer) {
+  UDPSource& udp = std::get<UDPSource>(source.state);
+  std::array<mmsghdr, UDP_RECV_BATCH> datagrams{};
+  std::array<iovec, UDP_RECV_BATCH> slots{};
+  for (uint32_t i = 0; i < UDP_RECV_BATCH; i++) {
+    slots[i] = {udp.buffer.data() + static_cast<size_t>(i) * UDP_DATAGRAM_MAX, UDP_DATAGRAM_MAX};
+    datagrams[i].msg_hdr.msg_iov = &slots[i];
+    datagrams[i].msg_hdr.msg_iovlen = 1;
+  }
+  const int count = recvmmsg(source.fd, datagrams.data(), UDP_RECV_BATCH, MSG_DONTWAIT, nullptr);
+  if (count < 0) {
+    if (errno == EINTR || wouldBlock()) return true;
+    publishError(txBuffer, socketError("UDP recv"));
+    return false;
+  }
+
+  canpBatchView_t batch{};
+  for (int i = 0; i < count; i++) {
+    if (datagrams[i].msg_hdr.msg_flags & MSG_TRUNC) {
+      udp.link.stats.malformed++;
+      continue;
+    }
+    // each datagram is parsed in place as a stream of its own
+    canpStream_t datagram{.data = static_cast<uint8_t*>(slots[i].iov_base),
+                          .size = UDP_DATAGRAM_MAX,
+                          .start = 0,
+                          .end = datagrams[i].msg_len};
+    int readStatus = CANP_READ_OK;
+    while ((readStatus = canpStreamNext(&datagram, &batch)) == CANP_READ_OK) {
+      if (!countSequence(udp, batch.seq)) continue;
+      udp.link.stats.batches++;
+      udp.link.stats.frames += batch.count;
+      if (arena) handleNetwork(batch, *arena);
+    }
+    if (readStatus != CANP_READ_MORE || datagram.start != datagram.end) udp.link.stats.malformed++;
+  }
+  return true;
+}
+
+void Protocols::closeUDP(IngestSource& source, SPMCQueue<ProtocolReceiveVariant, 32>& txBuffer) {
+  publishLinkStats(txBuffer, std::get<UDPSource>(source.state).link,
+                   std::chrono::steady_clock::now());
+  closeSocket(source.fd);
+  source.fd = INVALID_SOCKET;
+  publishMessage(txBuffer, timeNow() + "UDP stopped");
+}
+
+// frames are stamped by the kernel as they arrive, by the adapter as well when it can,
+// and every frame carries the socket's running count of frames the kernel dropped
+bool Protocols::openCAN(IngestSource& source, const PCANConfig& config, std::string& error) {
+  const unsigned int index = if_nametoindex(config.channel);
+  if (index == 0) {
+    error = socketError("CAN interface lookup");
+    return false;
+  }
+  if (config.bus >= CAN_BUS_MAX) {
+    error = "CAN bus " + std::to_string(config.bus) + " is out of range";
+    return false;
+  }
+  SocketHandle sock = socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, CAN_RAW);
+  if (sock == INVALID_SOCKET) {
+    error = socketError("CAN socket creation");
+    return false;
+  }
+  const int stamping = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+  const int enable = 1;
+  setsockopt(sock, SOL_SOCKET, SO_TIMESTAMPING, &stamping, sizeof(stamping));
+  setsockopt(sock, SOL_SOCKET, SO_RXQ_OVFL, &enable, sizeof(enable));
+  // nothing passes until the first filterCAN
+  setsockopt(sock, SOL_CAN_RAW, CAN_RAW_FILTER, nullptr, 0);
+
+  sockaddr_can address{};
+  address.can_family = AF_CAN;
+  address.can_ifindex = static_cast<int>(index);
+  if (bind(sock, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+    error = socketError("CAN bind");
+    closeSocket(sock);
+    return false;
+  }
+
+  CANSource can{.config = config};
+  can.frames.resize(CAN_RECV_BATCH);
+  can.control.resize(CAN_RECV_BATCH * CAN_CONTROL_BYTES);
+  can.link.stats.source = "CAN " + std::string(config.channel);
+  can.link.reported = std::chrono::steady_clock::now();
+  source.fd = sock;
+  source.events = EPOLLIN;
+  source.state = std::move(can);
+  return true;
+}
+
+// one filter per id the dbc has on this bus, a data frame passes if its id and format match
+// more than the kernel takes and every data frame passes, ingestFrames drops the rest
+void Protocols::filterCAN(IngestSource& source, const Arena& arena) {
+  CANSource& can = std::get<CANSource>(source.state);
+  if (can.filtered == arena.generation) return;
+  can.filtered = arena.generation;
+  std::vector<can_filter> filters{};
+  for (const uint32_t key : arena.validIds) {
+    if (messageBus(key) != can.config.bus) continue;
+    const uint32_t id = messageCanId(key);
+    const canid_t mask = CAN_EFF_FLAG | CAN_RTR_FLAG |
+                         ((id & CAN_EFF_FLAG) ? CAN_EFF_MASK : CAN_SFF_MASK);
+    filters.push_back({.can_id = id, .can_mask = mask});
+  }
+  if (filters.size() > CAN_RAW_FILTER_MAX)
+    filters.assign(1, {.can_id = 0, .can_mask = CAN_RTR_FLAG});
+  setsockopt(source.fd, SOL_CAN_RAW, CAN_RAW_FILTER, filters.data(),
+             static_cast<socklen_t>(filters.size() * sizeof(can_filter)));
+}
+
+// the kernel's receive stamp, else now. the adapter's raw stamp (ts[2]) counts from its own
+// clock rather than the unix epoch, so it would land frames decades away from other sources
+double frameTimeSeconds(msghdr& header) {
+  for (cmsghdr* control = CMSG_FIRSTHDR(&header); control;
+       control = CMSG_NXTHDR(&header, control)) {
+    if (control->cmsg_level != SOL_SOCKET || control->cmsg_type != SO_TIMESTAMPING) continue;
+    scm_timestamping stamps{};
+    std::memcpy(&stamps, CMSG_DATA(control), sizeof(stamps));
+    const timespec& stamp = stamps.ts[0];
+    if (!stamp.tv_sec && !stamp.tv_nsec) break;
+    return static_cast<double>(stamp.tv_sec) + static_cast<double>(stamp.tv_nsec) * 1e-9;
+  }
+  const auto now = std::chrono::system_clock::now().time_since_epoch();
+  return std::chrono::duration<double>(now).count();
+}
+
+// the kernel's count of frames it dropped for this socket, in the newest frame that has it
+void countDropped(msghdr& header, LinkCounters& link) {
+  for (cmsghdr* control = CMSG_FIRSTHDR(&header); control;
+       control = CMSG_NXTHDR(&header, control)) {
+    if (control->cmsg_level != SOL_SOCKET || control->cmsg_type != SO_RXQ_OVFL) continue;
+    uint32_t dropped = 0;
+    std::memcpy(&dropped, CMSG_DATA(control), sizeof(dropped));
+    link.stats.lost = dropped;
+  }
+}
+
+bool Protocols::stepCAN(IngestSource& source, Arena* arena,
+                        SPMCQueue<ProtocolReceiveVariant, 32>& txBuffer) {
+  CANSource& can = std::get<CANSource>(source.state);
+  std::array<mmsghdr, CAN_RECV_BATCH> messages{};
+  std::array<iovec, CAN_RECV_BATCH> slots{};
+  for (uint32_t i = 0; i < CAN_RECV_BATCH; i++) {
+    slots[i] = {&can.frames[i], sizeof(can_frame)};
+    messages[i].msg_hdr.msg_iov = &slots[i];
+    messages[i].msg_hdr.msg_iovlen = 1;
+    messages[i].msg_hdr.msg_control = can.control.data() + i * CAN_CONTROL_BYTES;
+    messages[i].msg_hdr.msg_controllen = CAN_CONTROL_BYTES;
+  }
+  const int count = recvmmsg(source.fd, messages.data(), CAN_RECV_BATCH, MSG_DONTWAIT, nullptr);
+  if (count < 0) {
+    if (errno == EINTR || wouldBlock()) return true;
+    publishError(txBuffer, socketError("CAN recv"));
+    return false;
+  }
+
+  // remote and error frames carry no signals, a dlc past 8 makes ingestFrames skip them
+  FrameBatch frames;
+  frames.payload = can.frames[0].data;
+  frames.stride = sizeof(can_frame);
+  frames.count = static_cast<uint16_t>(count);
+  for (int i = 0; i < count; i++) {
+    const can_frame& frame = can.frames[i];
+    const canid_t raw = frame.can_id;
+    const bool data = messages[i].msg_len == sizeof(can_frame) &&
+                      !(raw & (CAN_RTR_FLAG | CAN_ERR_FLAG));
+    const uint32_t id = raw & CAN_EFF_FLAG ? raw & (CAN_EFF_FLAG | CAN_EFF_MASK)
+                                           : raw & CAN_SFF_MASK;
+    frames.keys[i] = messageKey(can.config.bus, id);
+    frames.dlcs[i] = data ? frame.len : UINT8_MAX;
+    frames.times[i] = frameTimeSeconds(messages[i].msg_hdr);
+    if (!data) can.link.stats.malformed++;
+  }
+  if (count) countDropped(messages[count - 1].msg_hdr, can.link);
+  can.link.stats.batches++;
+  can.link.stats.frames += static_cast<uint64_t>(count);
+  if (arena) ingestFrames(frames, *arena);
+  return true;
+}
+
+void Protocols::closeCAN(IngestSource& source, SPMCQueue<ProtocolReceiveVariant, 32>& txBuffer) {
+  publishLinkStats(txBuffer, std::get<CANSource>(source.state).link,
+                   std::chrono::steady_clock::now());
+  closeSocket(source.fd);
+  source.fd = INVALID_SOCKET;
+  publishMessage(txBuffer, timeNow() + "CAN stopped");
+}
+
+speed_t baudSpeed(uint32_t baudRate) {
+  switch (baudRate) {
+    case 9600: return B9600;
+    case 19200: return B19200;
+    case 38400: return B38400;
+    case 57600: return B57600;
+    case 115200: return B115200;
+    case 230400: return B230400;
+    case 460800: return B460800;
+    case 500000: return B500000;
+    case 921600: return B921600;
+    case 1000000: return B1000000;
+    case 2000000: return B2000000;
+    case 3000000: return B3000000;
+    case 4000000: return B4000000;
+    default: return B0;
+  }
+}
+
+// raw 8N1 with no flow control, reads return whatever the driver holds without waiting
+bool Protocols::openUART(IngestSource& source, const UARTConfig& config, std::string& error) {
+  const speed_t speed = baudSpeed(config.baudRate);
+  if (speed == B0) {
+    error = "unsupported UART baud rate: " + std::to_string(config.baudRate);
+    return false;
+  }
+  const int fd = ::open(config.device, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+  if (fd < 0) {
+    error = socketError(("UART open " + std::string(config.device)).c_str());
+    return false;
+  }
+  termios tty{};
+  if (tcgetattr(fd, &tty) != 0) {
+    error = socketError("UART attributes");
+    ::close(fd);
+    return false;
+  }
+  cfmakeraw(&tty);
+  tty.c_cflag |= CLOCAL | CREAD;
+  tty.c_cflag &= ~(CSTOPB | CRTSCTS);
+  tty.c_cc[VMIN] = 0;
+  tty.c_cc[VTIME] = 0;
+  cfsetispeed(&tty, speed);
+  cfsetospeed(&tty, speed);
+  if (tcsetattr(fd, TCSANOW, &tty) != 0) {
+    error = socketError("UART configure");
+    ::close(fd);
+    return false;
+  }
+  // whatever sat in the driver before open is from an older stream
+  tcflush(fd, TCIFLUSH);
+
+  UARTSource uart{.config = config};
+  if (canpStreamInit(&uart.stream, CANP_STREAM_SIZE) != 0) {
+    error = "CANP stream allocation failed";
+    ::close(fd);
+    return false;
+  }
+  uart.link.stats.source = "UART " + std::string(config.device);
+  uart.link.reported = std::chrono::steady_clock::now();
+  source.fd = fd;
+  source.events = EPOLLIN;
+  source.state = uart;
+  return true;
+}
+
+// seq only moves forward on a serial link, a gap is batches lost to dropped bytes
+void countSerialSequence(UARTSource& uart, uint32_t seq) {
+  const auto ahead = static_cast<int32_t>(seq - uart.nextSeq);
+  if (uart.sequenced && ahead > 0 && ahead <= UART_RESTART_GAP)
+    uart.link.stats.lost += static_cast<uint32_t>(ahead);
+  uart.sequenced = true;
+  uart.nextSeq = seq + 1;
+}
+
+// one read per wakeup like stepTCP, lost bytes cost the batches they fell in, not the stream
+bool Protocols::stepUART(IngestSource& source, Arena* arena,
+                         SPMCQueue<ProtocolReceiveVariant, 32>& txBuffer) {
+  UARTSource& uart = std::get<UARTSource>(source.state);
+  const int readStatus = canpStreamRead(source.fd, &uart.stream);
+  if (readStatus == CANP_READ_SOCKET_ERROR && wouldBlock()) return true;
+  if (readStatus == CANP_READ_CLOSED) {
+    publishMessage(txBuffer, timeNow() + "UART device closed");
+    return false;
+  }
+  if (readStatus != CANP_READ_OK) {
+    publishError(txBuffer, socketError("UART read"));
+    return false;
+  }
+
+  // each damaged stretch between two batches that framed counts as one malformed
+  canpBatchView_t batch{};
+  for (;;) {
+    size_t skipped = 0;
+    const int status = canpStreamNextSync(&uart.stream, &batch, &skipped);
+    if (skipped) uart.link.stats.malformed++;
+    uart.skipped += skipped;
+    if (status != CANP_READ_OK) break;
+    countSerialSequence(uart, batch.seq);
+    uart.link.stats.batches++;
+    uart.link.stats.frames += batch.count;
+    if (arena) handleNetwork(batch, *arena);
+  }
+  return true;
+}
+
+void Protocols::closeUART(IngestSource& source, SPMCQueue<ProtocolReceiveVariant, 32>& txBuffer) {
+  UARTSource& uart = std::get<UARTSource>(source.state);
+  publishLinkStats(txBuffer, uart.link, std::chrono::steady_clock::now());
+  canpStreamFree(&uart.stream);
+  ::close(source.fd);
+  source.fd = -1;
+  const std::string skipped = std::to_string(uart.skipped);
+  publishMessage(txBuffer, timeNow() + "UART stopped, " + skipped + " bytes skipped to resync");
+}
+#endif
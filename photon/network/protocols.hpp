@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "../parse/arena.hpp"
+#include "../parse/parse.hpp"
 #include "../parse/spmc.hpp"
 
 #ifdef LINUX
@@ -49,6 +50,8 @@ struct PCANConfig {
   bool busoffReset = false;
   float samplePointPercent = 87.5f;
   char channel[1024] = "can0";
+  // the dbc bus this channel's frames are decoded as
+  uint32_t bus = 0;
 };
 
 struct BLEConfig {};
@@ -85,6 +88,8 @@ struct PCANConfig {
   bool busoffReset = false;
   float samplePointPercent = 87.5f;
   char channel[1024] = "can0";
+  // the dbc bus this channel's frames are decoded as
+  uint32_t bus = 0;
 };
 
 struct BLEConfig {};
@@ -103,11 +108,50 @@ struct ProtocolMessage {
 struct ProtocolDeviceList {
   std::vector<std::string> devices;
 };
+
+// counters of one source since it opened, sent about once a second while it receives
+// lost and reordered are whole batches, judged by their CANP seq
+struct ProtocolLinkStats {
+  std::string source{};
+  uint64_t batches{};
+  uint64_t frames{};
+  uint64_t lost{};
+  uint64_t reordered{};
+  uint64_t malformed{};
+  double framesPerSecond{};
+};
+
 using ProtocolTransmitVariant =
     std::variant<TCPConfig, UDPConfig, UARTConfig, PCANConfig, BLEConfig, WLANConfig, Quit>;
-using ProtocolReceiveVariant = std::variant<ProtocolError, ProtocolMessage, ProtocolDeviceList>;
+using ProtocolReceiveVariant =
+    std::variant<ProtocolError, ProtocolMessage, ProtocolDeviceList, ProtocolLinkStats>;
+
+#ifdef LINUX
+struct IngestSource;
+#endif
 
 struct Protocols {
   static void TCP(std::stop_token stoken, SPMCQueue<ProtocolReceiveVariant, 32>& txBuffer,
-                  TCPConfig config, Arena& arena);
+                  TCPConfig config, Parse& parse);
+#ifdef LINUX
+  // the same stream as a source of the ingest loop, step returns false once it is done
+  static bool openTCP(IngestSource& source, const TCPConfig& config, std::string& error);
+  static bool stepTCP(IngestSource& source, Arena* arena,
+                      SPMCQueue<ProtocolReceiveVariant, 32>& txBuffer);
+  static void closeTCP(IngestSource& source, SPMCQueue<ProtocolReceiveVariant, 32>& txBuffer);
+  static bool openUDP(IngestSource& source, const UDPConfig& config, std::string& error);
+  static bool stepUDP(IngestSource& source, Arena* arena,
+                      SPMCQueue<ProtocolReceiveVariant, 32>& txBuffer);
+  static void closeUDP(IngestSource& source, SPMCQueue<ProtocolReceiveVariant, 32>& txBuffer);
+  static bool openCAN(IngestSource& source, const PCANConfig& config, std::string& error);
+  static bool stepCAN(IngestSource& source, Arena* arena,
+                      SPMCQueue<ProtocolReceiveVariant, 32>& txBuffer);
+  static void filterCAN(IngestSource& source, const Arena& arena);
+  static void closeCAN(IngestSource& source, SPMCQueue<ProtocolReceiveVariant, 32>& txBuffer);
+  static bool openUART(IngestSource& source, const UARTConfig& config, std::string& error);
+  static bool stepUART(IngestSource& source, Arena* arena,
+                       SPMCQueue<ProtocolReceiveVariant, 32>& txBuffer);
+  static void closeUART(IngestSource& source, SPMCQueue<ProtocolReceiveVariant, 32>& txBuffer);
+  static void reportLink(IngestSource& source, SPMCQueue<ProtocolReceiveVariant, 32>& txBuffer);
+#endif
 };
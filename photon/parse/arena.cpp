@@ -1,15 +1,24 @@
 #include "arena.hpp"
 
 #include <algorithm>
+#include <bit>
+#include <cmath>
 #include <cstdio>
 #include <cstring>
+#include <limits>
 #include <memory>
+#include <thread>
+#include <utility>
 #ifdef _WIN32
 #include <windows.h>
 #else
 #include <sys/mman.h>
+#include <unistd.h>
 #endif
 #include "../engine/include.hpp"
+#include "batch.hpp"
+#include "decode.hpp"
+#include "session.hpp"
 
 inline void formatBytes(char* out, size_t outSize, uint64_t bytes) {
   static constexpr std::array<const char*, 6> units{"B", "KB", "MB", "GB", "TB", "PB"};
@@ -30,19 +39,31 @@ void Arena::status() {
   logs("time buffers      : " << totalTimeBuffers);
   logs("total buffers     : " << totalBuffers);
   logs("total pages       : " << totalPages);
-  formatBytes(bytes, sizeof(bytes), bytesPerBuffer);
-  logs("bytes per buffer  : " << bytes);
-  formatBytes(bytes, sizeof(bytes), arenaSize - (bytesPerBuffer * totalBuffers));
+  formatBytes(bytes, sizeof(bytes), capacityBytes);
+  logs("buffer bytes      : " << bytes);
+  formatBytes(bytes, sizeof(bytes), arenaSize - capacityBytes);
   logs("unused            : " << bytes);
-  logs("points per buffer : " << bytesPerBuffer / sizeof(double));
+  logs("retention target  : " << retention << " s");
+  logs("ring buffers      : " << (ring ? "yes" : "no"));
+  logs("blocked layout    : " << (blocked ? "yes" : "no"));
+  logs("raw payloads      : " << (raw ? "yes" : "no"));
+  logs("typed columns     : " << (typed ? "yes" : "no"));
   for (const auto& i : validIds) {
-    Message* msg = messages[i];
+    Message* msg = message(i);
     if (!msg) continue;
-    logs("message id        : " << msg->id);
+    logs("message id        : " << messageCanId(msg->id));
+    logs("bus               : " << msg->bus);
     logs("message name      : " << msg->name);
     logs("dlc               : " << msg->dlc);
     logs("signal count      : " << msg->signalCount);
     logs("signal size       : " << msg->signalSize.value.load(std::memory_order_acquire));
+    logs("expected rate     : " << msg->rate << " Hz");
+    logs("points per buffer : " << msg->capacity / sizeof(double));
+    logs("bits per frame    : " << msg->frameBits);
+    if (msg->muxCount) {
+      logs("multiplexor       : " << msg->muxSignal << (msg->tapped ? " (tapped)" : ""));
+      logs("mux groups        : " << msg->muxCount);
+    }
     logs("time ptr          : " << msg->timeData);
     logs("transmitter       : " << msg->transmitter);
     for (size_t s{0uz}; s < msg->signalCount; s++) {
@@ -69,31 +90,130 @@ void Arena::status() {
 void Arena::init(const arenaConfig& config) {
   if (config.validIds.empty()) return;
 
-  std::vector<uint32_t> nextValidIds = config.validIds;
-  std::sort(nextValidIds.begin(), nextValidIds.end());
+  if (config.signalCounts.size() != config.validIds.size()) return;
+
+  const bool multiplexed = config.mux.size() == config.validIds.size();
+
+  const bool hasRates = config.rates.size() == config.validIds.size();
+  const bool hasColumns = config.columns.size() == config.validIds.size();
+
+  struct PendingMessage {
+    uint32_t id{};
+    uint32_t signalCount{};
+    const MuxConfig* mux{};
+    double rate{};
+    const std::vector<ColumnType>* columns{};
+  };
+  std::vector<PendingMessage> nextMessages{};
+  for (size_t i = 0; i < config.validIds.size() && nextMessages.size() < MESSAGE_MAX; i++) {
+    if (!validMessageId(messageCanId(config.validIds[i]))) continue;
+    const MuxConfig* mux = multiplexed ? &config.mux[i] : nullptr;
+    // a multiplexor that is not stored on the message cannot route anything
+    if (mux && (mux->values.empty() || mux->values.size() != mux->signalCounts.size() ||
+                mux->multiplexor >= std::min(config.signalCounts[i], SIGNAL_MAX)))
+      mux = nullptr;
+    const double rate = hasRates && config.rates[i] > 0.0 ? config.rates[i] : ARENA_DEFAULT_RATE;
+    const std::vector<ColumnType>* columns = hasColumns ? &config.columns[i] : nullptr;
+    nextMessages.push_back({config.validIds[i], config.signalCounts[i], mux, rate, columns});
+  }
+  std::sort(nextMessages.begin(), nextMessages.end(),
+            [](const PendingMessage& a, const PendingMessage& b) { return a.id < b.id; });
 
+  // a buffer's share of the pool follows the frames per second it receives,
+  // mux groups split their message's rate between them
+  // a raw message has a payload buffer next to its time buffer and none per signal,
+  // a typed signal has its column, decode windows live off the pool
+  const bool nextTyped = config.typed && !config.raw;
+  const uint32_t frameBuffers = config.raw ? 2 : 1;
+  const uint32_t signalBuffers = config.raw ? 0 : 1;
+  const size_t granule = nextTyped ? ARENA_COLUMN_GRANULE : 1;
+  // the doubles one frame of a message takes over its buffers, a column bits / 64 of one
+  auto weightOf = [&](uint32_t signals, const std::vector<ColumnType>* columns) {
+    double weight = frameBuffers;
+    for (uint32_t i = 0; i < signals; i++) {
+      const ColumnType column =
+          nextTyped && columns && i < columns->size() ? (*columns)[i] : ColumnType::Float64;
+      weight += signalBuffers * columnBits(column) / 64.0;
+    }
+    return weight;
+  };
   uint32_t nextTotalSignals = 0;
   uint32_t nextTotalTimeBuffers = 0;
-  for (const auto& idx : nextValidIds) {
-    uint32_t count = config.signalCounts[idx];
-    if (count > 32) count = 32;
-    nextTotalSignals += count;
+  uint32_t nextTotalGroups = 0;
+  double totalRate = 0.0;
+  double totalWeight = 0.0;
+  for (const PendingMessage& pending : nextMessages) {
+    const uint32_t signals = std::min(pending.signalCount, SIGNAL_MAX);
+    nextTotalSignals += signals;
     nextTotalTimeBuffers += 1;
+    const double weight = weightOf(signals, pending.columns);
+    totalRate += pending.rate * weight;
+    totalWeight += weight;
+    if (!pending.mux) continue;
+    const MuxConfig& mux = *pending.mux;
+    const uint32_t groups = std::min(static_cast<uint32_t>(mux.values.size()), MUX_GROUP_MAX);
+    for (uint32_t g = 0; g < groups; g++) {
+      const uint32_t groupSignals = std::min(mux.signalCounts[g], SIGNAL_MAX);
+      nextTotalSignals += groupSignals;
+      const double groupWeight = weightOf(
+          groupSignals, mux.columns.size() == mux.values.size() ? &mux.columns[g] : nullptr);
+      totalRate += pending.rate / groups * groupWeight;
+      totalWeight += groupWeight;
+    }
+    nextTotalTimeBuffers += groups;
+    nextTotalGroups += groups;
   }
-  const uint32_t nextTotalBuffers = nextTotalSignals + nextTotalTimeBuffers;
+  const uint32_t nextTotalBuffers =
+      nextTotalSignals * signalBuffers + nextTotalTimeBuffers * frameBuffers;
   if (nextTotalBuffers == 0) return;
 
-  const size_t nextArenaSize = std::max(config.arenaSize, static_cast<size_t>(MINIMUM_ARENA_SIZE));
+  // the pool grows past its minimum when the retention target needs more than it holds
+  const double retentionBytes = config.retention * totalRate * sizeof(double);
+  const auto reservedPages = static_cast<size_t>(std::ceil(totalWeight * granule));
+  const size_t retentionPages =
+      static_cast<size_t>(std::ceil(retentionBytes / PAGE_SIZE)) + reservedPages;
+  const size_t nextArenaSize =
+      std::max({config.arenaSize, static_cast<size_t>(MINIMUM_ARENA_SIZE),
+                retentionPages * PAGE_SIZE});
   const size_t nextTotalPages = nextArenaSize / PAGE_SIZE;
-  const size_t nextPagesPerBuffer = nextTotalPages / nextTotalBuffers;
-  if (nextPagesPerBuffer == 0) return;
+  if (reservedPages > nextTotalPages) return;
+  // every buffer gets a granule, the rest is split by rate and weight
+  const double spareGranules = static_cast<double>(nextTotalPages - reservedPages) / granule;
+  auto capacityFor = [&](double rate) {
+    const auto granules = 1 + static_cast<size_t>(spareGranules * rate / totalRate);
+    const size_t pages = std::min(granules * granule, ARENA_BUFFER_MAX / PAGE_SIZE);
+    return static_cast<uint32_t>(pages * PAGE_SIZE);
+  };
 
-  for (const auto& m : messages)
-    if (m) clear(m->id);
+  for (const auto& id : validIds) clear(id);
+  ring = false;
+#ifdef __linux__
+  // the memfd holds every buffer once, pool only reserves twice the address space for the views
+  // a session file stands in for the memfd, its buffers start after the header page
+  if (config.ring) {
+    ringOffset = config.session.empty() ? 0 : SESSION_DATA_OFFSET;
+    if (ringOffset)
+      ringFd = openSessionFile(config.session, config.reopen, nextArenaSize);
+    else
+      ringFd = memfd_create("photon-arena", MFD_CLOEXEC);
+    if (ringFd >= 0 && (ringOffset || ftruncate(ringFd, static_cast<off_t>(nextArenaSize)) == 0)) {
+      pool = mmap(nullptr, nextArenaSize * 2, PROT_NONE,
+                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+      ring = pool != MAP_FAILED;
+    }
+    if (!ring && ringFd >= 0) {
+      close(ringFd);
+      ringFd = -1;
+    }
+    if (!ring) logs("ring arena unavailable, falling back to linear buffers");
+    if (ring && ringOffset) session = config.session;
+  }
+  if (!ring)
+#endif
 #ifdef _WIN32
-  pool = VirtualAlloc(nullptr, nextArenaSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    pool = VirtualAlloc(nullptr, nextArenaSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
 #else
-  pool = mmap(nullptr, nextArenaSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    pool = mmap(nullptr, nextArenaSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
 #endif
   if (pool == nullptr
 #ifndef _WIN32
@@ -104,34 +224,216 @@ void Arena::init(const arenaConfig& config) {
     return;
   }
 
-  validIds = std::move(nextValidIds);
+  validIds.clear();
+  for (const PendingMessage& pending : nextMessages) validIds.push_back(pending.id);
   arenaSize = nextArenaSize;
   totalSignals = nextTotalSignals;
   totalTimeBuffers = nextTotalTimeBuffers;
   totalBuffers = nextTotalBuffers;
   generation++;
   cursor = static_cast<uint8_t*>(pool);
-  remaining = arenaSize;
+  remaining = ring ? arenaSize * 2 : arenaSize;
   totalPages = nextTotalPages;
-  pagesPerBuffer = nextPagesPerBuffer;
-  bytesPerBuffer = PAGE_SIZE * pagesPerBuffer;
-
-  for (const auto& idx : validIds) {
-    messages[idx] = new (Message);
-    Message& msg = *messages[idx];
-    msg.id = idx;
-    msg.signalCount = config.signalCounts[idx];
-    msg.signalSize.value.store(0, std::memory_order_relaxed);
-    if (msg.signalCount > 32) msg.signalCount = 32;
-    msg.timeData = alloc(bytesPerBuffer, PAGE_SIZE);
+  capacityBytes = 0;
+  retention = config.retention;
+  raw = config.raw;
+  typed = nextTyped;
+  blocked = config.blocked && !raw && !typed;
+
+  // every message and signal comes from one allocation each instead of one new per object
+  // mux groups sit after the indexed messages so msg.index stays dense
+  messageStore = std::make_unique<Message[]>(nextMessages.size() + nextTotalGroups);
+  signalStore = std::make_unique<Signal[]>(totalSignals);
+  std::vector<Message*> created{};
+  created.reserve(nextMessages.size());
+  uint32_t nextSignal = 0;
+  size_t nextGroup = nextMessages.size();
+  size_t lodTimes = 0;
+  size_t lodValues = 0;
+  size_t indexTimes = 0;
+  size_t windowValues = 0;
+  bool mapped = true;
+  auto allocMessage = [&](Message& msg, uint32_t id, uint32_t index, uint32_t signalCount,
+                          double rate, const std::vector<ColumnType>* columns) {
+    msg.id = id;
+    msg.bus = messageBus(id);
+    msg.index = index;
+    msg.signalCount = std::min(signalCount, SIGNAL_MAX);
+    msg.rate = rate;
+    msg.capacity = capacityFor(rate);
+    msg.frameBits = raw ? 128 : 64 * (msg.signalCount + 1);
+    msg.lodBuckets = std::max<uint32_t>(1, msg.capacity / sizeof(double) / ARENA_LOD_SHARE);
+    lodTimes += size_t{ARENA_LOD_LEVELS} * msg.lodBuckets;
+    lodValues += size_t{ARENA_LOD_LEVELS} * msg.lodBuckets * msg.signalCount;
+    msg.indexSlots = msg.capacity / sizeof(double) / ARENA_INDEX_FRAMES + 1;
+    indexTimes += msg.indexSlots;
+    // typed columns are counted as they are allocated
+    const uint32_t buffers = (typed ? 0 : msg.signalCount * signalBuffers) + frameBuffers;
+    capacityBytes += static_cast<size_t>(msg.capacity) * buffers;
+    clear(msg);
+    if (blocked) {
+      // one buffer of whole chunks, a frame lands in a single chunk instead of
+      // signalCount + 1 buffers far apart
+      msg.chunkStride = ARENA_CHUNK_FRAMES * sizeof(double) * (msg.signalCount + 1);
+      const size_t storeBytes = static_cast<size_t>(msg.capacity) * (msg.signalCount + 1);
+      auto* store = static_cast<uint8_t*>(allocBuffer(storeBytes));
+      msg.timeData = store;
+      mapped = mapped && store;
+      for (auto i{0uz}; i < msg.signalCount; i++) {
+        msg.signals[i] = &signalStore[nextSignal++];
+        msg.signals[i]->data =
+            store ? store + (i + 1) * ARENA_CHUNK_FRAMES * sizeof(double) : nullptr;
+      }
+      return;
+    }
+    msg.timeData = allocBuffer(msg.capacity);
+    mapped = mapped && msg.timeData;
+    if (raw) {
+      msg.payloadData = allocBuffer(msg.capacity);
+      mapped = mapped && msg.payloadData;
+    }
+    msg.typed = typed;
+    if (typed) msg.frameBits = 64;
+    if (raw || typed) {
+      msg.windowFrames =
+          std::min(msg.capacity / static_cast<uint32_t>(sizeof(double)), ARENA_DECODE_FRAMES);
+      windowValues += size_t{msg.windowFrames} * msg.signalCount;
+    }
     for (auto i{0uz}; i < msg.signalCount; i++) {
-      msg.signals[i] = new (Signal);
-      void* mem = alloc(bytesPerBuffer, PAGE_SIZE);
-      msg.signals[i]->data = mem;
+      Signal& sig = signalStore[nextSignal++];
+      msg.signals[i] = &sig;
+      if (raw) continue;
+      if (!typed) {
+        sig.data = allocBuffer(msg.capacity);
+        mapped = mapped && sig.data;
+        continue;
+      }
+      // a column holds a buffer's frames in bits / 64 of its bytes
+      sig.column = columns && i < columns->size() ? (*columns)[i] : ColumnType::Float64;
+      const size_t columnBytes = static_cast<size_t>(msg.capacity) * columnBits(sig.column) / 64;
+      sig.columnData = allocBuffer(columnBytes);
+      mapped = mapped && sig.columnData;
+      msg.frameBits += columnBits(sig.column);
+      capacityBytes += columnBytes;
     };
+  };
+  for (const PendingMessage& pending : nextMessages) {
+    Message& msg = messageStore[created.size()];
+    allocMessage(msg, pending.id, static_cast<uint32_t>(created.size()), pending.signalCount,
+                 pending.rate, pending.columns);
+    if (pending.mux) {
+      const MuxConfig& mux = *pending.mux;
+      msg.muxSignal = mux.multiplexor;
+      msg.tapped = mux.tapped;
+      msg.muxGroups = &messageStore[nextGroup];
+      msg.muxCount = std::min(static_cast<uint32_t>(mux.values.size()), MUX_GROUP_MAX);
+      // groups are laid out by value so muxGroup can binary search them
+      std::vector<uint32_t> order(msg.muxCount);
+      for (uint32_t g = 0; g < msg.muxCount; g++) order[g] = g;
+      std::sort(order.begin(), order.end(),
+                [&](uint32_t a, uint32_t b) { return mux.values[a] < mux.values[b]; });
+      for (const uint32_t g : order) {
+        Message& group = messageStore[nextGroup++];
+        const bool groupColumns = mux.columns.size() == mux.values.size();
+        allocMessage(group, pending.id, msg.index, mux.signalCounts[g],
+                     pending.rate / msg.muxCount, groupColumns ? &mux.columns[g] : nullptr);
+        group.muxValue = mux.values[g];
+      }
+    }
+    created.push_back(&msg);
+  }
+  messages.build(created);
+  storedMessages = static_cast<uint32_t>(nextGroup);
+
+  // pyramids, time indexes and decode windows live off the pool, they are small next to the
+  // buffers and never mapped twice
+  lodTimeStore = std::make_unique<double[]>(lodTimes);
+  lodStore = std::make_unique<LodBucket[]>(lodValues);
+  indexStore = std::make_unique<double[]>(indexTimes);
+  windowStore = std::make_unique<double[]>(windowValues);
+  size_t nextTime = 0;
+  size_t nextBucket = 0;
+  size_t nextIndex = 0;
+  size_t nextWindow = 0;
+  for (size_t m = 0; m < nextGroup; m++) {
+    Message& msg = messageStore[m];
+    msg.timeIndex = &indexStore[nextIndex];
+    nextIndex += msg.indexSlots;
+    msg.lodTime = &lodTimeStore[nextTime];
+    nextTime += size_t{ARENA_LOD_LEVELS} * msg.lodBuckets;
+    for (uint32_t i = 0; i < msg.signalCount; i++) {
+      msg.signals[i]->lod = &lodStore[nextBucket];
+      nextBucket += size_t{ARENA_LOD_LEVELS} * msg.lodBuckets;
+      if (!msg.windowFrames) continue;
+      msg.signals[i]->data = &windowStore[nextWindow];
+      nextWindow += msg.windowFrames;
+    }
+  }
+
+  // two mappings per buffer can run into the process map limit, linear buffers never do
+  if (ring && !mapped) {
+    logs("ring arena could not map every buffer, falling back to linear buffers");
+    destroy();
+    arenaConfig linear = config;
+    linear.ring = false;
+    init(linear);
+  }
+}
+
+// tries a fixed sequence of odd multipliers per table size and keeps the one
+// with the shortest worst case probe, growing the table until no id is displaced
+void MessageIndex::build(const std::vector<Message*>& messages) {
+  clear();
+  if (messages.empty()) return;
+
+  uint32_t bits = 1;
+  while ((size_t{1} << bits) < messages.size() * 2) bits++;
+
+  std::vector<Slot> candidate{};
+  uint64_t seed = 0x9E3779B97F4A7C15ull;
+  for (uint32_t grow = 0; grow < 4 && (slots.empty() || maxProbe > 0); grow++, bits++) {
+    const uint32_t size = 1u << bits;
+    for (uint32_t attempt = 0; attempt < 32; attempt++) {
+      seed += 0x9E3779B97F4A7C15ull;
+      uint64_t z = seed;
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+      const uint32_t nextMultiplier = static_cast<uint32_t>(z ^ (z >> 31)) | 1u;
+      const uint32_t nextShift = 32 - bits;
+
+      candidate.assign(size, Slot{});
+      uint32_t nextMaxProbe = 0;
+      for (Message* msg : messages) {
+        uint32_t slot = (msg->id * nextMultiplier) >> nextShift;
+        uint32_t probe = 0;
+        while (candidate[slot].id != EMPTY) {
+          slot = (slot + 1) & (size - 1);
+          probe++;
+        }
+        candidate[slot] = {msg->id, msg};
+        nextMaxProbe = std::max(nextMaxProbe, probe);
+      }
+
+      if (slots.empty() || nextMaxProbe < maxProbe) {
+        slots = candidate;
+        multiplier = nextMultiplier;
+        shift = nextShift;
+        mask = size - 1;
+        maxProbe = nextMaxProbe;
+      }
+      if (maxProbe == 0) return;
+    }
   }
 }
 
+void MessageIndex::clear() {
+  slots.clear();
+  multiplier = 0;
+  shift = 0;
+  mask = 0;
+  maxProbe = 0;
+}
+
 void* Arena::alloc(size_t bytes, size_t align) {
   void* p = cursor;
   if (!std::align(align, bytes, p, remaining)) return nullptr;
@@ -140,105 +442,1262 @@ void* Arena::alloc(size_t bytes, size_t align) {
   return p;
 };
 
-// clears the existing message
+// one signal or time buffer of bytes, a whole number of pages
+// a ring arena maps the buffer's slice of the memfd at base and again right after it,
+// so a run that passes the end continues into the start without a copy
+void* Arena::allocBuffer(size_t bytes) {
+  if (!ring) return alloc(bytes, PAGE_SIZE);
+#ifdef __linux__
+  auto* base = static_cast<uint8_t*>(alloc(bytes * 2, PAGE_SIZE));
+  if (!base) return nullptr;
+  const auto offset = static_cast<off_t>((base - static_cast<uint8_t*>(pool)) / 2 + ringOffset);
+  for (size_t half = 0; half < 2; half++) {
+    void* view = mmap(base + half * bytes, bytes, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_FIXED, ringFd, offset);
+    if (view == MAP_FAILED) return nullptr;
+  }
+  return base;
+#else
+  return nullptr;
+#endif
+}
+
+// tail is loaded first so a racing append can only make the run longer than a buffer,
+// which is trimmed back to the newest bytes
+void Arena::snapshot(const Message& msg, uint64_t& tail, uint64_t& head) const {
+  tail = msg.counters.tail.load(std::memory_order_acquire);
+  head = msg.counters.head.load(std::memory_order_acquire);
+  if (head - tail > msg.capacity) tail = head - msg.capacity;
+}
+
+// [tail, head) of one buffer of msg
+// blocked messages have no contiguous run and read as empty, walk their chunks instead
+void Arena::window(const Message& msg, void* buffer, void** data, uint32_t* size) const {
+  if (data) *data = nullptr;
+  if (size) *size = 0;
+  if (msg.chunkStride) return;
+  uint64_t tail = 0;
+  uint64_t head = 0;
+  snapshot(msg, tail, head);
+  const size_t offset = ring ? tail % msg.capacity : 0;
+  if (data) *data = buffer ? static_cast<uint8_t*>(buffer) + offset : nullptr;
+  if (size) *size = static_cast<uint32_t>(head - tail);
+}
+
+// [tail, head) of one signal, of a raw or typed one only the newest frames its decode
+// window holds, see Arena::decode
+void Arena::signalWindow(const Message& msg, uint32_t signal, void** data, uint32_t* size) {
+  if (data) *data = nullptr;
+  if (size) *size = 0;
+  uint64_t tail = 0;
+  uint64_t head = 0;
+  snapshot(msg, tail, head);
+  uint64_t first = tail / sizeof(double);
+  const uint64_t end = head / sizeof(double);
+  const double* values = decode(msg, signal, first, end);
+  if (!values) return;
+  if (data) *data = const_cast<double*>(values);
+  if (size) *size = static_cast<uint32_t>((end - first) * sizeof(double));
+}
+
+// the newest frames of msg, at most newest of them, from one snapshot of the counters
+ChunkCursor Arena::chunks(const Message& msg, uint64_t newest) const {
+  uint64_t tail = 0;
+  uint64_t head = 0;
+  snapshot(msg, tail, head);
+  const uint64_t end = head / sizeof(double);
+  const uint64_t frames = std::min(end - tail / sizeof(double), newest);
+  return {&msg, end - frames, end, ring};
+}
+
+// a blocked chunk ends every ARENA_CHUNK_FRAMES frames, a columnar run only where a
+// linear buffer does, ring views already continue past the end of theirs
+bool ChunkCursor::next(FrameChunk& chunk) {
+  if (!msg || !msg->timeData || frame >= end) return false;
+  const uint64_t frames = msg->capacity / sizeof(double);
+  const uint64_t slot = ring ? frame % frames : frame;
+  uint64_t count = end - frame;
+  const auto* time = static_cast<const double*>(msg->timeData);
+  if (msg->chunkStride) {
+    const uint64_t inChunk = slot % ARENA_CHUNK_FRAMES;
+    count = std::min<uint64_t>(count, ARENA_CHUNK_FRAMES - inChunk);
+    time += slot / ARENA_CHUNK_FRAMES * (msg->chunkStride / sizeof(double)) + inChunk;
+  } else {
+    time += slot;
+  }
+  chunk = {msg, frame, static_cast<uint32_t>(count), time};
+  frame += count;
+  return true;
+}
+
+// the time of one frame in any layout
+double frameTime(const Message& msg, bool ring, uint64_t frame) {
+  ChunkCursor cursor{&msg, frame, frame + 1, ring};
+  FrameChunk chunk{};
+  return cursor.next(chunk) ? chunk.time[0] : 0.0;
+}
+
+// the first frame of [first, end) stamped after time, or at or after it when !after
+// times are expected in append order, the checkpoints narrow the search to one stretch of
+// ARENA_INDEX_FRAMES frames before any frame is touched
+uint64_t Arena::timeBound(const Message& msg, uint64_t first, uint64_t end, double time,
+                          bool after) const {
+  auto before = [&](double stamp) { return after ? stamp <= time : stamp < time; };
+  if (first >= end) return end;
+  if (msg.timeIndex) {
+    uint64_t lo = (first + ARENA_INDEX_FRAMES - 1) / ARENA_INDEX_FRAMES;
+    const uint64_t oldest = lo;
+    uint64_t hi = (end + ARENA_INDEX_FRAMES - 1) / ARENA_INDEX_FRAMES;
+    while (lo < hi) {
+      const uint64_t mid = lo + (hi - lo) / 2;
+      if (before(msg.timeIndex[mid % msg.indexSlots]))
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    // checkpoint lo is the first one past time, so the bound is at or before it
+    if (lo * ARENA_INDEX_FRAMES < end) end = lo * ARENA_INDEX_FRAMES;
+    if (lo > oldest) first = (lo - 1) * ARENA_INDEX_FRAMES + 1;
+  }
+  while (first < end) {
+    const uint64_t mid = first + (end - first) / 2;
+    if (before(frameTime(msg, ring, mid)))
+      first = mid + 1;
+    else
+      end = mid;
+  }
+  return first;
+}
+
+// the held frames of msg stamped within [from, to], from one snapshot of the counters
+// works for every layout, blocked messages included
+ChunkCursor Arena::timeRange(const Message& msg, double from, double to) const {
+  uint64_t tail = 0;
+  uint64_t head = 0;
+  snapshot(msg, tail, head);
+  const uint64_t oldest = tail / sizeof(double);
+  const uint64_t newest = head / sizeof(double);
+  const uint64_t first = timeBound(msg, oldest, newest, from, false);
+  const uint64_t end = timeBound(msg, first, newest, to, true);
+  return {&msg, first, end, ring};
+}
+
+// reserves the next bytes of msg for one writer, any number may append to a message at once
+// a linear arena refuses once full, a ring arena retires the oldest bytes first, readers
+// still inside them see newer data, so they re-check tail when that matters
+// a ring never hands out bytes a writer ahead of it has not published yet, it waits instead
+bool Arena::beginAppend(Message& msg, size_t bytes, uint64_t& start) {
+  if (bytes > msg.capacity) return false;
+  uint64_t reserved = msg.counters.reserved.load(std::memory_order_relaxed);
+  for (;;) {
+    if (!ring && reserved + bytes > msg.capacity) return false;
+    if (ring && reserved + bytes - msg.counters.committed.load(std::memory_order_acquire) >
+                    msg.capacity) {
+      std::this_thread::yield();
+      reserved = msg.counters.reserved.load(std::memory_order_relaxed);
+      continue;
+    }
+    if (msg.counters.reserved.compare_exchange_weak(reserved, reserved + bytes,
+                                                    std::memory_order_relaxed))
+      break;
+  }
+  start = reserved;
+  if (!ring || start + bytes <= msg.capacity) return true;
+
+  const uint64_t retired = start + bytes - msg.capacity;
+  uint64_t tail = msg.counters.tail.load(std::memory_order_relaxed);
+  if (tail >= retired) return true;
+  while (tail < retired &&
+         !msg.counters.tail.compare_exchange_weak(tail, retired, std::memory_order_relaxed)) {
+  }
+  std::atomic_thread_fence(std::memory_order_release);
+  return true;
+}
+
+// publishes the bytes reserved at start once every writer that reserved before them has,
+// checkpointing their frames before head moves past them, then folds them into the pyramid
+// and makes the newest frame msg's latest, values as for publishLatest
+// the next writer waits for all of it, so a message still has one publisher at a time
+void Arena::endAppend(Message& msg, uint64_t start, size_t bytes, const double* time,
+                      const double* values, uint32_t stride) {
+  while (msg.counters.committed.load(std::memory_order_acquire) != start)
+    std::this_thread::yield();
+  const uint64_t head = start + bytes;
+  const uint64_t tail = std::min(msg.counters.tail.load(std::memory_order_relaxed), head);
+  if (msg.timeIndex) {
+    const uint64_t end = head / sizeof(double);
+    uint64_t checkpoint = (start / sizeof(double) + ARENA_INDEX_FRAMES - 1) / ARENA_INDEX_FRAMES;
+    for (; checkpoint * ARENA_INDEX_FRAMES < end; checkpoint++)
+      msg.timeIndex[checkpoint % msg.indexSlots] =
+          frameTime(msg, ring, checkpoint * ARENA_INDEX_FRAMES);
+  }
+  msg.counters.head.store(head, std::memory_order_release);
+  msg.signalSize.value.store(static_cast<uint32_t>(head - tail), std::memory_order_release);
+  if (!msg.payloadData && !msg.typed) foldLod(msg, UINT64_MAX);
+  if (bytes && time && values) publishLatest(msg, *time, values, stride);
+  msg.counters.committed.store(head, std::memory_order_release);
+}
+
+// takes over frames [tail, head) that are already in msg's buffers, as a reopened session
+// holds them, frames appended after head was recorded are kept while their times keep
+// going forward, then the index, pyramid and latest frame are rebuilt as appends would
+void Arena::restore(Message& msg, uint64_t head, uint64_t tail) {
+  const uint64_t frames = msg.capacity / sizeof(double);
+  uint64_t end = std::min(head / sizeof(double), ring ? UINT64_MAX : frames);
+  uint64_t first = std::min(tail / sizeof(double), end);
+  if (first < end) {
+    const uint64_t limit = ring ? end + frames : frames;
+    for (double last = frameTime(msg, ring, end - 1); end < limit; end++) {
+      const double next = frameTime(msg, ring, end);
+      if (!(next >= last)) break;
+      last = next;
+    }
+  }
+  first = std::max(first, end > frames ? end - frames : 0);
+  clear(msg);
+  msg.counters.tail.store(first * sizeof(double), std::memory_order_relaxed);
+  msg.counters.head.store(end * sizeof(double), std::memory_order_release);
+  msg.counters.reserved.store(end * sizeof(double), std::memory_order_relaxed);
+  msg.counters.committed.store(end * sizeof(double), std::memory_order_release);
+  msg.signalSize.value.store(static_cast<uint32_t>((end - first) * sizeof(double)),
+                             std::memory_order_release);
+  if (first >= end) return;
+
+  if (msg.timeIndex)
+    for (uint64_t checkpoint = (first + ARENA_INDEX_FRAMES - 1) / ARENA_INDEX_FRAMES;
+         checkpoint * ARENA_INDEX_FRAMES < end; checkpoint++)
+      msg.timeIndex[checkpoint % msg.indexSlots] =
+          frameTime(msg, ring, checkpoint * ARENA_INDEX_FRAMES);
+  if (!msg.payloadData && !msg.typed) foldLod(msg, UINT64_MAX);
+
+  std::array<double, SIGNAL_MAX> values{};
+  for (uint32_t i = 0; i < msg.signalCount; i++) gather(msg, i, end - 1, end, &values[i]);
+  publishLatest(msg, frameTime(msg, ring, end - 1), values.data(), 1);
+}
+
+// clears the existing message and its mux groups
 // if no message exists, simply returns
 void Arena::clear(uint32_t id) {
-  if (id >= messages.size() || !messages[id]) return;
-  messages[id]->signalSize.value.store(0, std::memory_order_release);
+  Message* msg = message(id);
+  if (!msg) return;
+  clear(*msg);
+  for (uint32_t g = 0; g < msg->muxCount; g++) clear(msg->muxGroups[g]);
 };
 
+// empties msg unless a writer is between beginAppend and endAppend, whose endAppend would
+// otherwise wait for a committed offset that no longer comes, returns whether it did
+// taking reserved back to 0 first turns away writers that have not reserved yet, and any that
+// reserve after wait in endAppend until committed is reset last
+bool Arena::clear(Message& msg) {
+  uint64_t committed = msg.counters.committed.load(std::memory_order_acquire);
+  if (!msg.counters.reserved.compare_exchange_strong(committed, 0, std::memory_order_acq_rel))
+    return false;
+  msg.counters.tail.store(0, std::memory_order_relaxed);
+  msg.counters.head.store(0, std::memory_order_release);
+  msg.signalSize.value.store(0, std::memory_order_release);
+  msg.lodResume = 0;
+  msg.lodFrame.store(0, std::memory_order_release);
+  if (msg.windowFrames) {
+    // frame numbers start over, what the windows hold no longer matches them
+    std::lock_guard lock(decodeMutex);
+    for (uint32_t i = 0; i < msg.signalCount; i++)
+      if (msg.signals[i]) msg.signals[i]->cachedFrom = msg.signals[i]->cachedTo = 0;
+  }
+  msg.counters.committed.store(0, std::memory_order_release);
+  return true;
+}
+
 // thread safe read
 // returns a pointer of the signals buffer
 // returns the current populated size of the buffer
 void Arena::read(uint32_t id, uint32_t signal, void** data, uint32_t* size) {
   if (data) *data = nullptr;
   if (size) *size = 0;
-  if (id >= messages.size() || !messages[id]) return;
+  Message* found = message(id);
+  if (!found) return;
 
-  Message& msg = *messages[id];
-  if (signal >= msg.signalCount || !msg.signals[signal]) return;
-
-  const uint32_t published = msg.signalSize.value.load(std::memory_order_acquire);
-  if (data) *data = msg.signals[signal]->data;
-  if (size) *size = published;
+  signalWindow(*found, signal, data, size);
 };
 
+// the newest count samples of a signal and their times from one snapshot of the counters
+// returns how many were available, both runs are contiguous even across a ring's wrap
+// raw and typed signals give at most the frames of their decode window
+uint32_t Arena::read(uint32_t id, uint32_t signal, uint32_t count, const double** values,
+                     const double** times) {
+  if (values) *values = nullptr;
+  if (times) *times = nullptr;
+  Message* found = message(id);
+  if (!found) return 0;
+
+  Message& msg = *found;
+  if (signal >= msg.signalCount || !msg.signals[signal] || !msg.timeData) return 0;
+  if (msg.chunkStride) return 0;
+
+  uint64_t tail = 0;
+  uint64_t head = 0;
+  snapshot(msg, tail, head);
+  const uint64_t end = head / sizeof(double);
+  uint64_t first = end - std::min<uint64_t>(count, (head - tail) / sizeof(double));
+  const double* run = decode(msg, signal, first, end);
+  if (!run) return 0;
+  if (values) *values = run;
+  if (times)
+    *times = static_cast<const double*>(msg.timeData) + offset(msg, first * sizeof(double)) /
+                                                            sizeof(double);
+  return static_cast<uint32_t>(end - first);
+}
+
 // thread safe write
 // appends the data to the signal buffer
 bool Arena::write(uint32_t id, uint32_t signal, void* data, uint32_t size) {
-  if (id >= messages.size() || !messages[id] || !data) return false;
-  Message& msg = *messages[id];
+  Message* found = message(id);
+  if (!found || !data) return false;
+  Message& msg = *found;
   if (signal >= msg.signalCount || !msg.signals[signal]) return false;
+  // blocked, raw and typed messages only take whole frames
+  if (msg.chunkStride || msg.payloadData || msg.typed) return false;
 
-  const uint32_t offset = msg.signalSize.value.load(std::memory_order_relaxed);
-  if (offset > bytesPerBuffer || size > bytesPerBuffer - offset) return false;
-
-  auto* dst = static_cast<uint8_t*>(msg.signals[signal]->data) + offset;
+  uint64_t start = 0;
+  if (!beginAppend(msg, size, start)) return false;
+  auto* dst = static_cast<uint8_t*>(msg.signals[signal]->data) + offset(msg, start);
   std::memcpy(dst, data, size);
-  msg.signalSize.value.store(offset + size, std::memory_order_release);
+  endAppend(msg, start, size);
   return true;
 };
 
 void Arena::readTime(uint32_t id, void** data, uint32_t* size) {
   if (data) *data = nullptr;
   if (size) *size = 0;
-  if (id >= messages.size() || !messages[id]) return;
+  Message* found = message(id);
+  if (!found) return;
+  window(*found, found->timeData, data, size);
+}
+
+bool Arena::appendFrame(uint32_t id, double timeValue, const double* signalValues,
+                        uint32_t signalCount) {
+  Message* found = message(id);
+  if (!found || !signalValues) return false;
+  Message& msg = *found;
+  if (signalCount != msg.signalCount) return false;
+  // one frame is a run of one per signal, a value apart
+  return appendFrames(msg, &timeValue, signalValues, 1, 1);
+}
+
+// appends frameCount frames at once
+// columns holds one run of frameCount values per signal, stride values apart
+bool Arena::appendFrames(uint32_t id, const double* timeValues, const double* columns,
+                         uint32_t stride, uint32_t frameCount) {
+  Message* found = message(id);
+  if (!found) return false;
+  return appendFrames(*found, timeValues, columns, stride, frameCount);
+}
 
-  Message& msg = *messages[id];
-  const uint32_t published = msg.signalSize.value.load(std::memory_order_acquire);
-  if (data) *data = msg.timeData;
-  if (size) *size = published;
+// frames of a blocked message split at chunk ends, a ring wraps back to chunk 0
+void appendChunks(Message& msg, uint64_t slot, const double* timeValues, const double* columns,
+                  uint32_t stride, uint32_t frameCount) {
+  const uint64_t frames = msg.capacity / sizeof(double);
+  const size_t chunkValues = msg.chunkStride / sizeof(double);
+  for (uint32_t done = 0; done < frameCount;) {
+    const uint64_t inChunk = slot % ARENA_CHUNK_FRAMES;
+    const auto run =
+        static_cast<uint32_t>(std::min<uint64_t>(frameCount - done, ARENA_CHUNK_FRAMES - inChunk));
+    double* chunk = static_cast<double*>(msg.timeData) + slot / ARENA_CHUNK_FRAMES * chunkValues +
+                    inChunk;
+    std::memcpy(chunk, timeValues + done, run * sizeof(double));
+    for (uint32_t i = 0; i < msg.signalCount; i++)
+      std::memcpy(chunk + (i + 1) * ARENA_CHUNK_FRAMES,
+                  columns + static_cast<size_t>(i) * stride + done, run * sizeof(double));
+    done += run;
+    slot = (slot + run) % frames;
+  }
 }
 
-bool Arena::writeTime(uint32_t id, void* data, uint32_t size) {
-  if (id >= messages.size() || !messages[id] || !data) return false;
-  Message& msg = *messages[id];
-  if (!msg.timeData) return false;
+// same as above for a message already looked up, mux groups are only reachable this way
+bool Arena::appendFrames(Message& msg, const double* timeValues, const double* columns,
+                         uint32_t stride, uint32_t frameCount) {
+  if (!timeValues || !columns) return false;
+  if (!msg.timeData || msg.payloadData || msg.typed || frameCount > stride) return false;
 
-  const uint32_t offset = msg.signalSize.value.load(std::memory_order_relaxed);
-  if (offset > bytesPerBuffer || size > bytesPerBuffer - offset) return false;
+  // a reservation has to be published, so nothing may fail once one is taken
+  if (!msg.chunkStride)
+    for (uint32_t i = 0; i < msg.signalCount; i++)
+      if (!msg.signals[i] || !msg.signals[i]->data) return false;
 
-  auto* dst = static_cast<uint8_t*>(msg.timeData) + offset;
-  std::memcpy(dst, data, size);
+  if (!frameCount) return true;
+
+  const size_t bytes = static_cast<size_t>(frameCount) * sizeof(double);
+  uint64_t start = 0;
+  if (!beginAppend(msg, bytes, start)) return false;
+  const double* newest = timeValues + frameCount - 1;
+
+  if (msg.chunkStride) {
+    appendChunks(msg, offset(msg, start) / sizeof(double), timeValues, columns, stride,
+                 frameCount);
+    endAppend(msg, start, bytes, newest, columns + frameCount - 1, stride);
+    return true;
+  }
+
+  const uint32_t at = offset(msg, start);
+  std::memcpy(static_cast<uint8_t*>(msg.timeData) + at, timeValues, bytes);
+  for (uint32_t i = 0; i < msg.signalCount; i++) {
+    const double* column = columns + static_cast<size_t>(i) * stride;
+    std::memcpy(static_cast<uint8_t*>(msg.signals[i]->data) + at, column, bytes);
+  }
+
+  endAppend(msg, start, bytes, newest, columns + frameCount - 1, stride);
   return true;
 }
 
-bool Arena::appendFrame(uint32_t id, double timeValue, const double* signalValues,
-                        uint32_t signalCount) {
-  if (id >= messages.size() || !messages[id] || !signalValues) return false;
-  Message& msg = *messages[id];
-  if (signalCount != msg.signalCount || !msg.timeData) return false;
+// the undecoded field of count payload words at native width, sign extended if signed
+template <typename T>
+void storeColumn(const DecodePlan& plan, const uint64_t* words, uint32_t count, T* out) {
+  for (uint32_t i = 0; i < count; i++) {
+    const uint64_t raw = decodeRaw(plan, words[i], std::byteswap(words[i]));
+    if constexpr (std::is_same_v<T, float>)
+      out[i] = std::bit_cast<float>(static_cast<uint32_t>(raw));
+    else if constexpr (std::is_signed_v<T>)
+      out[i] = static_cast<T>(static_cast<int64_t>(raw << plan.signShift) >> plan.signShift);
+    else
+      out[i] = static_cast<T>(raw);
+  }
+}
+
+// writes the column values of count frames starting at slot, ring slots may run into the
+// second view which is the same memory
+void storeColumns(Message& msg, uint64_t slot, const uint64_t* words, uint32_t count) {
+  for (uint32_t s = 0; s < msg.signalCount; s++) {
+    Signal* sig = msg.signals[s];
+    if (!sig || !sig->columnData) continue;
+    const DecodePlan& plan = sig->plan;
+    switch (sig->column) {
+      case ColumnType::Bit: {
+        // another writer's frames may share the first and last byte, those bits are set atomically
+        auto* bytes = static_cast<uint8_t*>(sig->columnData);
+        const uint64_t firstByte = slot >> 3;
+        const uint64_t lastByte = (slot + count - 1) >> 3;
+        for (uint32_t i = 0; i < count; i++) {
+          const uint64_t bit = slot + i;
+          const uint64_t raw = decodeRaw(plan, words[i], std::byteswap(words[i]));
+          const auto value = static_cast<uint8_t>(raw & 1);
+          const auto mask = static_cast<uint8_t>(1u << (bit & 7));
+          uint8_t& byte = bytes[bit >> 3];
+          if ((bit >> 3) != firstByte && (bit >> 3) != lastByte)
+            byte = static_cast<uint8_t>((byte & ~mask) | (value ? mask : 0));
+          else if (value)
+            std::atomic_ref(byte).fetch_or(mask, std::memory_order_relaxed);
+          else
+            std::atomic_ref(byte).fetch_and(static_cast<uint8_t>(~mask), std::memory_order_relaxed);
+        }
+        break;
+      }
+      case ColumnType::Int8:
+        storeColumn(plan, words, count, static_cast<int8_t*>(sig->columnData) + slot);
+        break;
+      case ColumnType::UInt8:
+        storeColumn(plan, words, count, static_cast<uint8_t*>(sig->columnData) + slot);
+        break;
+      case ColumnType::Int16:
+        storeColumn(plan, words, count, static_cast<int16_t*>(sig->columnData) + slot);
+        break;
+      case ColumnType::UInt16:
+        storeColumn(plan, words, count, static_cast<uint16_t*>(sig->columnData) + slot);
+        break;
+      case ColumnType::Int32:
+        storeColumn(plan, words, count, static_cast<int32_t*>(sig->columnData) + slot);
+        break;
+      case ColumnType::UInt32:
+        storeColumn(plan, words, count, static_cast<uint32_t*>(sig->columnData) + slot);
+        break;
+      case ColumnType::Float32:
+        storeColumn(plan, words, count, static_cast<float*>(sig->columnData) + slot);
+        break;
+      case ColumnType::Float64:
+      default: {
+        // whatever the width, the value before scale and offset
+        DecodePlan unscaled = plan;
+        unscaled.scale = 1.0;
+        unscaled.offset = 0.0;
+        auto* out = static_cast<double*>(sig->columnData) + slot;
+        for (uint32_t i = 0; i < count; i++)
+          if (!decodeSignal(unscaled, words[i], std::byteswap(words[i]), 8, out[i])) out[i] = 0.0;
+        break;
+      }
+    }
+  }
+}
+
+// appends the payload words of frameCount frames of a raw or typed message, a raw message
+// keeps them as they are and a typed one splits them into its columns, neither decodes
+bool Arena::appendPayloads(Message& msg, const double* timeValues, const uint64_t* words,
+                           uint32_t frameCount) {
+  if (!timeValues || !words || !msg.timeData) return false;
+  if (!msg.payloadData && !msg.typed) return false;
+
+  if (!frameCount) return true;
+
+  // only the newest frame is decoded up front, for the latest record
+  std::array<double, SIGNAL_MAX> values{};
+  const uint64_t word = words[frameCount - 1];
+  const uint64_t swapped = std::byteswap(word);
+  for (uint32_t i = 0; i < msg.signalCount; i++)
+    if (msg.signals[i]) decodeSignal(msg.signals[i]->plan, word, swapped, 8, values[i]);
+
+  const size_t bytes = static_cast<size_t>(frameCount) * sizeof(double);
+  uint64_t start = 0;
+  if (!beginAppend(msg, bytes, start)) return false;
+  const uint32_t at = offset(msg, start);
+  std::memcpy(static_cast<uint8_t*>(msg.timeData) + at, timeValues, bytes);
+  if (msg.payloadData)
+    std::memcpy(static_cast<uint8_t*>(msg.payloadData) + at, words, bytes);
+  else
+    storeColumns(msg, at / sizeof(double), words, frameCount);
+  endAppend(msg, start, bytes, timeValues + frameCount - 1, values.data());
+  return true;
+}
+
+// signal i of the frame is values[i * stride], only the writer whose turn it is publishes,
+// see endAppend
+void Arena::publishLatest(Message& msg, double time, const double* values, uint32_t stride) {
+  LatestFrame& latest = msg.latest;
+  const uint64_t sequence = latest.sequence.load(std::memory_order_relaxed);
+  latest.sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  latest.time.store(time, std::memory_order_relaxed);
+  for (uint32_t i = 0; i < msg.signalCount; i++)
+    latest.values[i].store(values[static_cast<size_t>(i) * stride], std::memory_order_relaxed);
+  latest.sequence.store(sequence + 2, std::memory_order_release);
+}
 
-  const uint32_t offset = msg.signalSize.value.load(std::memory_order_relaxed);
-  if (offset > bytesPerBuffer || sizeof(double) > bytesPerBuffer - offset) return false;
+// retries while a frame is being published, false until msg has had one
+bool Arena::latest(const Message& msg, LatestSnapshot& out) const {
+  const LatestFrame& latest = msg.latest;
+  for (;;) {
+    const uint64_t sequence = latest.sequence.load(std::memory_order_acquire);
+    if (sequence & 1) continue;
+    out.time = latest.time.load(std::memory_order_relaxed);
+    out.count = msg.signalCount;
+    for (uint32_t i = 0; i < msg.signalCount; i++)
+      out.values[i] = latest.values[i].load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (latest.sequence.load(std::memory_order_relaxed) != sequence) continue;
+    out.updates = sequence / 2;
+    return sequence != 0;
+  }
+}
 
-  auto* timeDst = static_cast<uint8_t*>(msg.timeData) + offset;
-  std::memcpy(timeDst, &timeValue, sizeof(double));
+// the newest value of one signal, three loads when no frame is being published
+bool Arena::latest(const SignalHandle& handle, double& value, double* time) const {
+  const Message* msg = message(handle);
+  if (!msg || handle.signal >= msg->signalCount) return false;
+  const LatestFrame& latest = msg->latest;
+  for (;;) {
+    const uint64_t sequence = latest.sequence.load(std::memory_order_acquire);
+    if (sequence & 1) continue;
+    const double sample = latest.values[handle.signal].load(std::memory_order_relaxed);
+    const double stamp = latest.time.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (latest.sequence.load(std::memory_order_relaxed) != sequence) continue;
+    if (sequence == 0) return false;
+    value = sample;
+    if (time) *time = stamp;
+    return true;
+  }
+}
+
+// the first signal called name, messages before their mux groups, a tapped pack repeats
+// its signals in every group and resolves to its lowest tap
+// a linear scan, meant to run once per dbc load rather than per read
+SignalHandle Arena::resolve(std::string_view name) const {
+  for (uint32_t m = 0; m < storedMessages; m++) {
+    const Message& msg = messageStore[m];
+    for (uint32_t i = 0; i < msg.signalCount; i++)
+      if (msg.signals[i] && name == msg.signals[i]->name) return {m, i, generation};
+  }
+  return {UINT32_MAX, 0, generation};
+}
+
+// null once the handle's arena generation has been replaced
+const Message* Arena::message(const SignalHandle& handle) const {
+  if (handle.generation != generation || handle.message >= storedMessages) return nullptr;
+  return &messageStore[handle.message];
+}
+
+template <typename T>
+void expandColumn(const void* column, uint64_t slot, uint64_t count, const DecodePlan& plan,
+                  double* out) {
+  const T* src = static_cast<const T*>(column) + slot;
+  for (uint64_t i = 0; i < count; i++)
+    out[i] = static_cast<double>(src[i]) * plan.scale + plan.offset;
+}
+
+// count frames of a typed signal from slot on, scale and offset are applied here
+void expandColumns(const Signal& sig, uint64_t slot, uint64_t count, double* out) {
+  const DecodePlan& plan = sig.plan;
+  switch (sig.column) {
+    case ColumnType::Bit: {
+      const auto* bytes = static_cast<const uint8_t*>(sig.columnData);
+      for (uint64_t i = 0; i < count; i++) {
+        const uint64_t bit = slot + i;
+        out[i] = static_cast<double>((bytes[bit >> 3] >> (bit & 7)) & 1) * plan.scale + plan.offset;
+      }
+      break;
+    }
+    case ColumnType::Int8:
+      expandColumn<int8_t>(sig.columnData, slot, count, plan, out);
+      break;
+    case ColumnType::UInt8:
+      expandColumn<uint8_t>(sig.columnData, slot, count, plan, out);
+      break;
+    case ColumnType::Int16:
+      expandColumn<int16_t>(sig.columnData, slot, count, plan, out);
+      break;
+    case ColumnType::UInt16:
+      expandColumn<uint16_t>(sig.columnData, slot, count, plan, out);
+      break;
+    case ColumnType::Int32:
+      expandColumn<int32_t>(sig.columnData, slot, count, plan, out);
+      break;
+    case ColumnType::UInt32:
+      expandColumn<uint32_t>(sig.columnData, slot, count, plan, out);
+      break;
+    case ColumnType::Float32:
+      expandColumn<float>(sig.columnData, slot, count, plan, out);
+      break;
+    case ColumnType::Float64:
+    default:
+      expandColumn<double>(sig.columnData, slot, count, plan, out);
+      break;
+  }
+}
+
+// frames [first, end) of one raw or typed signal from the payload words or its column into
+// out, a ring's second view keeps every run contiguous
+void decodeFrames(const Message& msg, const Signal& sig, bool ring, uint64_t first, uint64_t end,
+                  double* out) {
+  const uint64_t frames = msg.capacity / sizeof(double);
+  if (first >= end) return;
+  if (msg.typed) {
+    if (sig.columnData)
+      expandColumns(sig, ring ? first % frames : first, end - first, out);
+    else
+      std::fill_n(out, end - first, 0.0);
+    return;
+  }
+  DecodeLanes lanes;
+  while (first < end) {
+    const uint64_t slot = ring ? first % frames : first;
+    const auto count = static_cast<uint32_t>(std::min<uint64_t>(end - first, DECODE_LANES_MAX));
+    const uint64_t* words = static_cast<const uint64_t*>(msg.payloadData) + slot;
+    for (uint32_t i = 0; i < count; i++) {
+      lanes.words[i] = words[i];
+      lanes.swapped[i] = std::byteswap(words[i]);
+    }
+    lanes.count = count;
+    decodeLanes(sig.plan, lanes, out);
+    first += count;
+    out += count;
+  }
+}
+
+// frames [first, end) of one signal as one contiguous run, returns frame first's value
+// a raw or typed signal is decoded into its window, which keeps what earlier reads decoded
+// when the run extends it and slides forward when the run does not fit, first moves up to
+// the newest windowFrames frames and the run stays valid until the signal's next decode
+// blocked messages have no contiguous run and read as nullptr
+const double* Arena::decode(const Message& msg, uint32_t signal, uint64_t& first, uint64_t end) {
+  if (msg.chunkStride || signal >= msg.signalCount || !msg.signals[signal]) return nullptr;
+  Signal& sig = *msg.signals[signal];
+  if (!sig.data) return nullptr;
+  if (!msg.windowFrames)
+    return static_cast<const double*>(sig.data) + offset(msg, first * sizeof(double)) /
+                                                      sizeof(double);
+  first = std::max<uint64_t>(first, end > msg.windowFrames ? end - msg.windowFrames : 0);
+  if (first >= end) return nullptr;
+
+  auto* window = static_cast<double*>(sig.data);
+  std::lock_guard lock(decodeMutex);
+  const uint64_t from = sig.cachedFrom;
+  const uint64_t to = sig.cachedTo;
+  if (first >= from && first <= to && end - from <= msg.windowFrames) {
+    if (end > to) decodeFrames(msg, sig, ring, to, end, window + (to - from));
+    sig.cachedTo = std::max(end, to);
+    return window + (first - from);
+  }
+  // whatever of the run is already decoded moves to the start of the window
+  uint64_t kept = first;
+  if (first >= from && first < to) {
+    std::memmove(window, window + (first - from), (to - first) * sizeof(double));
+    kept = to;
+  }
+  decodeFrames(msg, sig, ring, kept, end, window + (kept - first));
+  sig.cachedFrom = first;
+  sig.cachedTo = end;
+  return window;
+}
 
-  for (uint32_t i = 0; i < signalCount; i++) {
-    Signal* sig = msg.signals[i];
-    if (!sig || !sig->data) return false;
-    auto* dst = static_cast<uint8_t*>(sig->data) + offset;
-    std::memcpy(dst, &signalValues[i], sizeof(double));
+// frames [first, end) of one signal into out in any layout, without touching its decode
+// window, a missing signal reads as 0
+void Arena::gather(const Message& msg, uint32_t signal, uint64_t first, uint64_t end,
+                   double* out) const {
+  if (first >= end) return;
+  const Signal* sig = signal < msg.signalCount ? msg.signals[signal] : nullptr;
+  if (sig && (msg.payloadData || msg.typed)) {
+    decodeFrames(msg, *sig, ring, first, end, out);
+    return;
   }
+  ChunkCursor cursor{&msg, first, end, ring};
+  FrameChunk chunk{};
+  while (cursor.next(chunk)) {
+    const double* column = sig && sig->data ? chunk.signal(signal) : nullptr;
+    if (column)
+      std::memcpy(out, column, chunk.count * sizeof(double));
+    else
+      std::fill_n(out, chunk.count, 0.0);
+    out += chunk.count;
+  }
+}
+
+// the samples of a signal stamped within [from, to] and their times, contiguous as for the
+// newest count, raw and typed signals give the newest of them their decode window holds,
+// blocked messages read as empty, walk timeRange instead
+uint32_t Arena::readRange(uint32_t id, uint32_t signal, double from, double to,
+                          const double** values, const double** times) {
+  if (values) *values = nullptr;
+  if (times) *times = nullptr;
+  Message* found = message(id);
+  if (!found) return 0;
+
+  Message& msg = *found;
+  if (signal >= msg.signalCount || !msg.signals[signal] || !msg.timeData) return 0;
+  if (msg.chunkStride) return 0;
+
+  const ChunkCursor range = timeRange(msg, from, to);
+  uint64_t first = range.frame;
+  const double* run = decode(msg, signal, first, range.end);
+  if (!run) return 0;
+  if (values) *values = run;
+  if (times)
+    *times = static_cast<const double*>(msg.timeData) + offset(msg, first * sizeof(double)) /
+                                                            sizeof(double);
+  return static_cast<uint32_t>(range.end - first);
+}
 
-  msg.signalSize.value.store(offset + sizeof(double), std::memory_order_release);
+// the newest sample of a signal stamped at or before time, and its stamp
+// false when none is held, or a ring overwrote it while it was read
+bool Arena::readAsOf(uint32_t id, uint32_t signal, double time, double& value, double* stamp) {
+  Message* found = message(id);
+  if (!found) return false;
+
+  Message& msg = *found;
+  if (signal >= msg.signalCount || !msg.signals[signal] || !msg.timeData) return false;
+  const Signal& sig = *msg.signals[signal];
+
+  uint64_t tail = 0;
+  uint64_t head = 0;
+  snapshot(msg, tail, head);
+  const uint64_t oldest = tail / sizeof(double);
+  const uint64_t bound = timeBound(msg, oldest, head / sizeof(double), time, true);
+  if (bound == oldest) return false;
+
+  // one frame is gathered on its own rather than moving the signal's decode window
+  const uint64_t frame = bound - 1;
+  if (msg.typed ? !sig.columnData : (!msg.payloadData && !sig.data)) return false;
+  double sample = 0.0;
+  gather(msg, signal, frame, bound, &sample);
+  const double sampleTime = frameTime(msg, ring, frame);
+
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (frame * sizeof(double) < msg.counters.tail.load(std::memory_order_relaxed)) return false;
+  value = sample;
+  if (stamp) *stamp = sampleTime;
   return true;
 }
 
-void Arena::destroy() {
-  for (const auto& id : validIds) {
-    clear(id);
-    if (id >= messages.size() || !messages[id]) continue;
-    Message* msg = messages[id];
-    for (size_t i = 0; i < msg->signalCount; ++i) {
-      delete msg->signals[i];
-      msg->signals[i] = nullptr;
+// the Bit column of a typed signal over [tail, head) of one snapshot
+bool Arena::readBits(uint32_t id, uint32_t signal, BitRun& run) const {
+  run = {};
+  const Message* msg = message(id);
+  if (!msg || !msg->typed || signal >= msg->signalCount || !msg->signals[signal]) return false;
+  const Signal& sig = *msg->signals[signal];
+  if (sig.column != ColumnType::Bit || !sig.columnData) return false;
+  uint64_t tail = 0;
+  uint64_t head = 0;
+  snapshot(*msg, tail, head);
+  const uint64_t first = tail / sizeof(double);
+  const uint64_t slot = ring ? first % (msg->capacity / sizeof(double)) : first;
+  run.bytes = static_cast<const uint8_t*>(sig.columnData);
+  run.firstBit = slot;
+  run.count = static_cast<uint32_t>((head - tail) / sizeof(double));
+  run.time = static_cast<const double*>(msg->timeData) + slot;
+  run.scale = sig.scale;
+  run.offset = sig.offset;
+  return true;
+}
+
+// folds one chunk into every level of msg's pyramid, signals holds each signal's column of it
+void foldChunk(Message& msg, const FrameChunk& chunk,
+               const std::array<const double*, SIGNAL_MAX>& signals) {
+  for (uint32_t k = 0; k < ARENA_LOD_LEVELS; k++) {
+    const uint32_t shift = std::countr_zero(ARENA_LOD_FACTOR) * (k + 1);
+    double* times = msg.lodTime + static_cast<size_t>(k) * msg.lodBuckets;
+    for (uint32_t f = 0; f < chunk.count;) {
+      const uint64_t at = chunk.first + f;
+      const uint64_t bucket = at >> shift;
+      const uint64_t start = std::max(bucket << shift, msg.lodResume);
+      const uint64_t bucketEnd = (bucket + 1) << shift;
+      const auto run = static_cast<uint32_t>(std::min<uint64_t>(chunk.count - f, bucketEnd - at));
+      const uint64_t slot = bucket % msg.lodBuckets;
+      if (at == start) times[slot] = chunk.time[f];
+      for (uint32_t i = 0; i < msg.signalCount; i++) {
+        Signal* sig = msg.signals[i];
+        const double* values = signals[i];
+        if (!sig || !sig->lod || !values) continue;
+        double lo = values[f];
+        double hi = values[f];
+        double sum = 0.0;
+        for (uint32_t j = f; j < f + run; j++) {
+          lo = std::min(lo, values[j]);
+          hi = std::max(hi, values[j]);
+          sum += values[j];
+        }
+        LodBucket& out = sig->lod[static_cast<size_t>(k) * msg.lodBuckets + slot];
+        double& total = sig->lodSum[k];
+        if (at == start) {
+          out.min = static_cast<float>(lo);
+          out.max = static_cast<float>(hi);
+          total = sum;
+        } else {
+          out.min = std::min(out.min, static_cast<float>(lo));
+          out.max = std::max(out.max, static_cast<float>(hi));
+          total += sum;
+        }
+        out.mean = static_cast<float>(total / static_cast<double>(at + run - start));
+      }
+      f += run;
+    }
+  }
+}
+
+// folds frames [lodFrame, end) of msg into every level of its pyramid, a bucket at a time
+// frames a ring dropped unfolded are skipped, the bucket they cut restarts at lodResume
+// columnar messages fold on append, raw and typed ones under lodMutex from foldPending and
+// when read, so the ingest thread never decodes
+void Arena::foldLod(Message& msg, uint64_t end) {
+  if (!msg.lodTime) return;
+  uint64_t tail = 0;
+  uint64_t head = 0;
+  snapshot(msg, tail, head);
+  end = std::min(end, head / sizeof(double));
+  uint64_t frame = msg.lodFrame.load(std::memory_order_relaxed);
+  if (frame > end) frame = 0;
+  if (frame < tail / sizeof(double)) {
+    frame = tail / sizeof(double);
+    msg.lodResume = frame;
+  }
+  if (frame >= end) return;
+
+  // raw and typed signals are gathered a chunk's worth of frames at a time
+  const bool gathered = msg.payloadData || msg.typed;
+  std::array<double, SIGNAL_MAX * ARENA_CHUNK_FRAMES> columns{};
+  std::array<const double*, SIGNAL_MAX> signals{};
+  ChunkCursor cursor{&msg, frame, end, ring};
+  FrameChunk whole{};
+  while (cursor.next(whole)) {
+    const uint32_t step = gathered ? ARENA_CHUNK_FRAMES : whole.count;
+    for (uint32_t done = 0; done < whole.count; done += step) {
+      const FrameChunk chunk{&msg, whole.first + done, std::min(whole.count - done, step),
+                             whole.time + done};
+      for (uint32_t i = 0; i < msg.signalCount; i++) {
+        signals[i] = chunk.signal(i);
+        if (!gathered || !msg.signals[i]) continue;
+        gather(msg, i, chunk.first, chunk.first + chunk.count, &columns[i * ARENA_CHUNK_FRAMES]);
+        signals[i] = &columns[i * ARENA_CHUNK_FRAMES];
+      }
+      foldChunk(msg, chunk, signals);
     }
-    delete msg;
-    messages[id] = nullptr;
   }
+  msg.lodFrame.store(end, std::memory_order_release);
+}
+
+// folds every raw and typed message, mux groups included, called from Parse::compactLoop
+// often enough that a ring never overwrites frames before their pyramid has them
+void Arena::foldPending() {
+  for (uint32_t m = 0; m < storedMessages; m++) {
+    Message& msg = messageStore[m];
+    if (!msg.payloadData && !msg.typed) continue;
+    std::lock_guard lock(lodMutex);
+    foldLod(msg, UINT64_MAX);
+  }
+}
+
+// at most pixels columns of one signal over [from, to], from the finest of the held frames
+// and the pyramid levels that reaches back to from and fits, or the coarsest one with runs
+// of its buckets merged into each column, times are expected in append order
+uint32_t Arena::readLod(uint32_t id, uint32_t signal, double from, double to, uint32_t pixels,
+                        const LodColumns& out) {
+  Message* found = message(id);
+  pixels = static_cast<uint32_t>(std::min<size_t>(
+      {pixels, out.time.size(), out.min.size(), out.max.size(), out.mean.size()}));
+  if (!found || pixels == 0) return 0;
+  Message& msg = *found;
+  if (signal >= msg.signalCount || !msg.signals[signal] || !msg.lodTime) return 0;
+  const Signal& sig = *msg.signals[signal];
+  if (!sig.lod) return 0;
+  if (msg.payloadData || msg.typed) {
+    std::lock_guard lock(lodMutex);
+    foldLod(msg, UINT64_MAX);
+  }
+
+  uint64_t tail = 0;
+  uint64_t head = 0;
+  snapshot(msg, tail, head);
+  const uint64_t folded = msg.lodFrame.load(std::memory_order_acquire);
+  const uint64_t resume = msg.lodResume;
+  // level 0 is the frames themselves, level k + 1 is pyramid level k
+  auto itemTime = [&](uint32_t level, uint64_t item) {
+    if (level == 0) return frameTime(msg, ring, item);
+    return msg.lodTime[static_cast<size_t>(level - 1) * msg.lodBuckets + item % msg.lodBuckets];
+  };
+  // the first item of [lo, hi) starting after time, frames go through the time index
+  auto bound = [&](uint32_t level, uint64_t lo, uint64_t hi, double time) {
+    if (level == 0) return timeBound(msg, lo, hi, time, true);
+    while (lo < hi) {
+      const uint64_t mid = lo + (hi - lo) / 2;
+      if (itemTime(level, mid) <= time)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    return lo;
+  };
+
+  uint32_t pick = 0;
+  uint64_t first = 0;
+  uint64_t end = 0;
+  for (uint32_t level = 0; level <= ARENA_LOD_LEVELS; level++) {
+    uint64_t oldest = tail / sizeof(double);
+    uint64_t newest = head / sizeof(double);
+    bool complete = oldest <= resume;
+    if (level > 0) {
+      // the oldest slot may be mid overwrite, it is left out
+      const uint32_t shift = std::countr_zero(ARENA_LOD_FACTOR) * level;
+      newest = folded ? ((folded - 1) >> shift) + 1 : 0;
+      oldest = newest > msg.lodBuckets - 1 ? newest - (msg.lodBuckets - 1) : 0;
+      oldest = std::max(oldest, resume >> shift);
+      complete = oldest <= resume >> shift;
+    }
+    if (oldest >= newest) continue;
+    if (!complete && itemTime(level, oldest) > from && level < ARENA_LOD_LEVELS) continue;
+    // the item holding from, through the last item starting at or before to
+    const uint64_t lo = bound(level, oldest, newest, from);
+    const uint64_t rangeFirst = lo > oldest ? lo - 1 : oldest;
+    pick = level;
+    first = rangeFirst;
+    end = std::max(bound(level, lo, newest, to), rangeFirst);
+    if (end - first <= pixels) break;
+  }
+  if (first >= end) return 0;
+
+  uint32_t count = 0;
+  if (pick == 0) {
+    end = std::min(end, first + pixels);
+    gather(msg, signal, first, end, out.mean.data());
+    ChunkCursor cursor{&msg, first, end, ring};
+    FrameChunk chunk{};
+    while (cursor.next(chunk)) {
+      std::copy_n(chunk.time, chunk.count, out.time.begin() + count);
+      count += chunk.count;
+    }
+    std::copy_n(out.mean.begin(), count, out.min.begin());
+    std::copy_n(out.mean.begin(), count, out.max.begin());
+    return count;
+  }
+
+  const LodBucket* buckets = sig.lod + static_cast<size_t>(pick - 1) * msg.lodBuckets;
+  const uint64_t group = (end - first + pixels - 1) / pixels;
+  for (uint64_t item = first; item < end && count < pixels; item += group, count++) {
+    const uint64_t last = std::min(item + group, end);
+    double lo = buckets[item % msg.lodBuckets].min;
+    double hi = buckets[item % msg.lodBuckets].max;
+    double sum = 0.0;
+    for (uint64_t b = item; b < last; b++) {
+      const LodBucket& bucket = buckets[b % msg.lodBuckets];
+      lo = std::min(lo, static_cast<double>(bucket.min));
+      hi = std::max(hi, static_cast<double>(bucket.max));
+      sum += bucket.mean;
+    }
+    out.time[count] = itemTime(pick, item);
+    out.min[count] = lo;
+    out.max[count] = hi;
+    out.mean[count] = sum / static_cast<double>(last - item);
+  }
+  return count;
+}
+
+Message* Arena::muxGroup(uint32_t id, uint32_t value) const {
+  const Message* msg = message(id);
+  return msg ? msg->muxGroup(value) : nullptr;
+}
+
+// thread safe read of a signal stored under one multiplexor value
+void Arena::readMux(uint32_t id, uint32_t value, uint32_t signal, void** data, uint32_t* size) {
+  if (data) *data = nullptr;
+  if (size) *size = 0;
+  const Message* group = muxGroup(id, value);
+  if (!group) return;
+  signalWindow(*group, signal, data, size);
+}
+
+void Arena::readMuxTime(uint32_t id, uint32_t value, void** data, uint32_t* size) {
+  if (data) *data = nullptr;
+  if (size) *size = 0;
+  const Message* group = muxGroup(id, value);
+  if (!group) return;
+  window(*group, group->timeData, data, size);
+}
+
+// reads an array valued signal of a tapped pack, one series per tap in tap order
+// returns the number of taps written
+uint32_t Arena::readTaps(uint32_t id, uint32_t signal, std::span<TapSeries> taps) {
+  const Message* msg = message(id);
+  if (!msg || !msg->tapped) return 0;
+
+  const uint32_t count = std::min(msg->muxCount, static_cast<uint32_t>(taps.size()));
+  for (uint32_t t = 0; t < count; t++) {
+    const Message& group = msg->muxGroups[t];
+    taps[t] = {};
+    if (!group.timeData) continue;
+    // the same snapshot for both, raw and typed taps give the frames their window holds
+    uint64_t tail = 0;
+    uint64_t head = 0;
+    snapshot(group, tail, head);
+    uint64_t first = tail / sizeof(double);
+    const uint64_t end = head / sizeof(double);
+    const double* values = decode(group, signal, first, end);
+    if (!values) continue;
+    taps[t].values = values;
+    taps[t].time = static_cast<const double*>(group.timeData) +
+                   offset(group, first * sizeof(double)) / sizeof(double);
+    taps[t].size = static_cast<uint32_t>((end - first) * sizeof(double));
+  }
+  return count;
+}
+
+// the newest value of every tap, taps that have not been seen yet read as nan
+uint32_t Arena::latestTaps(uint32_t id, uint32_t signal, std::span<double> values) const {
+  const Message* msg = message(id);
+  if (!msg || !msg->tapped) return 0;
+
+  const auto count = static_cast<uint32_t>(std::min<size_t>(msg->muxCount, values.size()));
+  for (uint32_t t = 0; t < count; t++) {
+    values[t] = std::numeric_limits<double>::quiet_NaN();
+    const Message& group = msg->muxGroups[t];
+    const ChunkCursor newest = chunks(group, 1);
+    if (newest.frame >= newest.end || signal >= group.signalCount || !group.signals[signal])
+      continue;
+    gather(group, signal, newest.frame, newest.end, &values[t]);
+  }
+  return count;
+}
+
+// frames per second over the held window, 0 until two distinct times are held
+double Arena::measuredRate(const Message& msg) const {
+  ChunkCursor oldest = chunks(msg);
+  ChunkCursor newest = chunks(msg, 1);
+  const uint64_t samples = oldest.end - oldest.frame;
+  FrameChunk first{};
+  FrameChunk last{};
+  if (samples < 2 || !oldest.next(first) || !newest.next(last)) return 0.0;
+  const double span = last.time[0] - first.time[0];
+  if (!(span > 0.0)) return 0.0;
+  return static_cast<double>(samples - 1) / span;
+}
+
+// the config this arena was built from, with measured rates in place of expected ones
+// wherever a message has been heard, see Parse::resize
+arenaConfig Arena::layout() const {
+  arenaConfig config{
+      .arenaSize = MINIMUM_ARENA_SIZE,
+      .retention = retention,
+      .ring = ring,
+      .blocked = blocked,
+      .raw = raw,
+      .typed = typed,
+  };
+  auto columnsOf = [](const Message& msg) {
+    std::vector<ColumnType> columns{};
+    for (uint32_t i = 0; i < msg.signalCount; i++)
+      columns.push_back(msg.signals[i] ? msg.signals[i]->column : ColumnType::Float64);
+    return columns;
+  };
+  for (const uint32_t id : validIds) {
+    const Message* msg = message(id);
+    if (!msg) continue;
+    MuxConfig mux{.multiplexor = msg->muxSignal, .tapped = msg->tapped};
+    for (uint32_t g = 0; g < msg->muxCount; g++) {
+      mux.values.push_back(msg->muxGroups[g].muxValue);
+      mux.signalCounts.push_back(msg->muxGroups[g].signalCount);
+      mux.columns.push_back(columnsOf(msg->muxGroups[g]));
+    }
+    const double measured = measuredRate(*msg);
+    config.validIds.push_back(id);
+    config.signalCounts.push_back(msg->signalCount);
+    config.columns.push_back(columnsOf(*msg));
+    config.mux.push_back(std::move(mux));
+    config.rates.push_back(measured > 0.0 ? measured : msg->rate);
+  }
+  return config;
+}
+
+// appends one chunk of a typed message to another typed message with the same columns
+void Arena::copyColumns(Message& to, const Message& from, const FrameChunk& chunk) {
+  const size_t bytes = static_cast<size_t>(chunk.count) * sizeof(double);
+  uint64_t start = 0;
+  if (!beginAppend(to, bytes, start)) return;
+  const uint64_t toSlot = offset(to, start) / sizeof(double);
+  const auto fromSlot =
+      static_cast<uint64_t>(chunk.time - static_cast<const double*>(from.timeData));
+  std::memcpy(static_cast<uint8_t*>(to.timeData) + offset(to, start), chunk.time, bytes);
+  for (uint32_t i = 0; i < to.signalCount; i++) {
+    Signal* dst = to.signals[i];
+    const Signal* src = from.signals[i];
+    if (!dst || !src || !dst->columnData || !src->columnData || dst->column != src->column)
+      continue;
+    if (dst->column == ColumnType::Bit) {
+      auto* out = static_cast<uint8_t*>(dst->columnData);
+      const auto* in = static_cast<const uint8_t*>(src->columnData);
+      for (uint64_t f = 0; f < chunk.count; f++) {
+        const uint64_t inBit = fromSlot + f;
+        const uint64_t outBit = toSlot + f;
+        const auto value = static_cast<uint8_t>((in[inBit >> 3] >> (inBit & 7)) & 1);
+        uint8_t& byte = out[outBit >> 3];
+        byte = static_cast<uint8_t>((byte & ~(1u << (outBit & 7))) | (value << (outBit & 7)));
+      }
+      continue;
+    }
+    const uint32_t width = columnBits(dst->column) / 8;
+    std::memcpy(static_cast<uint8_t*>(dst->columnData) + toSlot * width,
+                static_cast<const uint8_t*>(src->columnData) + fromSlot * width,
+                static_cast<size_t>(chunk.count) * width);
+  }
+  endAppend(to, start, bytes);
+}
+
+// fills an arena initialized from old.layout() with old's descriptions and the newest
+// samples that fit each new buffer, old keeps taking appends while this runs, see catchUp
+void Arena::copyFrom(const Arena& old) {
+  strings = old.strings;
+  const char* oldBegin = old.strings.data();
+  const char* oldEnd = oldBegin + old.strings.size();
+  auto rebase = [&](const char* name) {
+    return name >= oldBegin && name < oldEnd ? strings.data() + (name - oldBegin) : name;
+  };
+  copiedFrames.assign(storedMessages, UINT64_MAX);
+  auto copyMessage = [&](Message& to, const Message& from) {
+    to.dlc = from.dlc;
+    to.decode = from.decode;
+    to.name = rebase(from.name);
+    to.transmitter = rebase(from.transmitter);
+    const uint32_t count = std::min(to.signalCount, from.signalCount);
+    for (uint32_t i = 0; i < count; i++) {
+      Signal* sig = to.signals[i];
+      const Signal* source = from.signals[i];
+      if (!sig || !source) continue;
+      void* data = sig->data;
+      void* columnData = sig->columnData;
+      const ColumnType column = sig->column;
+      LodBucket* lod = sig->lod;
+      *sig = *source;
+      sig->data = data;
+      sig->name = rebase(source->name);
+      sig->unit = rebase(source->unit);
+      sig->receiver = rebase(source->receiver);
+      sig->cachedFrom = 0;
+      sig->cachedTo = 0;
+      sig->column = column;
+      sig->columnData = columnData;
+      sig->lod = lod;
+      sig->lodSum = {};
+    }
+
+    if (count != to.signalCount || count != from.signalCount) return;
+    const ChunkCursor cursor = old.chunks(from, to.capacity / sizeof(double));
+    copiedFrames[&to - messageStore.get()] = cursor.end;
+    copyFrames(to, old, from, cursor);
+  };
+
+  for (const uint32_t id : validIds) {
+    Message* to = message(id);
+    const Message* from = old.message(id);
+    if (!to || !from) continue;
+    copyMessage(*to, *from);
+    const uint32_t groups = std::min(to->muxCount, from->muxCount);
+    for (uint32_t g = 0; g < groups; g++) copyMessage(to->muxGroups[g], from->muxGroups[g]);
+  }
+  buildDecodePlans(*this);
+}
+
+// takes over the frames old was given after copyFrom read each message, once nothing appends
+// to old anymore, frames a ring already overwrote are gone, as are messages copyFrom skipped
+void Arena::catchUp(const Arena& old) {
+  auto catchUpMessage = [&](Message& to, const Message& from) {
+    uint64_t& copied = copiedFrames[&to - messageStore.get()];
+    if (copied == UINT64_MAX) return;
+    ChunkCursor cursor = old.chunks(from);
+    cursor.frame = std::max(cursor.frame, copied);
+    copied = cursor.end;
+    if (cursor.frame < cursor.end) copyFrames(to, old, from, cursor);
+  };
+  for (const uint32_t id : validIds) {
+    Message* to = message(id);
+    const Message* from = old.message(id);
+    if (!to || !from) continue;
+    catchUpMessage(*to, *from);
+    const uint32_t groups = std::min(to->muxCount, from->muxCount);
+    for (uint32_t g = 0; g < groups; g++) catchUpMessage(to->muxGroups[g], from->muxGroups[g]);
+  }
+}
+
+// replays old's frames under cursor through appendFrames so either layout can be copied
+// into either, then takes over old's latest frame
+void Arena::copyFrames(Message& to, const Arena& old, const Message& from, ChunkCursor cursor) {
+  std::array<double, SIGNAL_MAX * ARENA_CHUNK_FRAMES> columns{};
+  FrameChunk chunk{};
+  while (cursor.next(chunk)) {
+    if (to.payloadData) {
+      if (chunk.payload()) appendPayloads(to, chunk.time, chunk.payload(), chunk.count);
+      continue;
+    }
+    if (to.typed) {
+      if (from.typed) copyColumns(to, from, chunk);
+      continue;
+    }
+    for (uint32_t done = 0; done < chunk.count; done += ARENA_CHUNK_FRAMES) {
+      const uint32_t run = std::min(chunk.count - done, ARENA_CHUNK_FRAMES);
+      for (uint32_t i = 0; i < to.signalCount; i++)
+        old.gather(from, i, chunk.first + done, chunk.first + done + run,
+                   &columns[i * ARENA_CHUNK_FRAMES]);
+      appendFrames(to, chunk.time + done, columns.data(), ARENA_CHUNK_FRAMES, run);
+    }
+  }
+  LatestSnapshot last{};
+  if (old.latest(from, last)) publishLatest(to, last.time, last.values.data(), 1);
+}
+
+void Arena::destroy() {
+  // the final checkpoint has to see the counters before they are cleared
+  closeSession(*this);
+  for (const auto& id : validIds) clear(id);
+  messages.clear();
+  storedMessages = 0;
+  messageStore.reset();
+  signalStore.reset();
+  lodTimeStore.reset();
+  lodStore.reset();
+  indexStore.reset();
+  windowStore.reset();
   validIds.clear();
+  strings.clear();
   totalSignals = 0;
   totalTimeBuffers = 0;
   totalBuffers = 0;
@@ -246,8 +1705,7 @@ void Arena::destroy() {
   cursor = nullptr;
   remaining = 0;
   totalPages = 0;
-  pagesPerBuffer = 0;
-  bytesPerBuffer = 0;
+  capacityBytes = 0;
   if (pool == nullptr) {
     arenaSize = 0;
     return;
@@ -255,8 +1713,17 @@ void Arena::destroy() {
 #ifdef _WIN32
   VirtualFree(pool, 0, MEM_RELEASE);
 #else
-  munmap(pool, arenaSize);
+  // one munmap over the reservation drops every view of a ring arena as well
+  munmap(pool, ring ? arenaSize * 2 : arenaSize);
+  if (ringFd >= 0) close(ringFd);
+  ringFd = -1;
+  ringOffset = 0;
+  session.clear();
 #endif
+  ring = false;
+  blocked = false;
+  raw = false;
+  typed = false;
   pool = nullptr;
   arenaSize = 0;
 }
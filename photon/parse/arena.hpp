@@ -1,21 +1,167 @@
 #pragma once
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
 constexpr uint32_t PAGE_SIZE = 4096;
+// most messages one arena holds, ids themselves span the full 29 bit space
 constexpr uint32_t MESSAGE_MAX = 0x2000;
 constexpr uint32_t SIGNAL_MAX = 32;
+// most multiplexor values one message stores separately
+constexpr uint32_t MUX_GROUP_MAX = 64;
 constexpr uint32_t MINIMUM_ARENA_SIZE = PAGE_SIZE * MESSAGE_MAX * SIGNAL_MAX;
+// frames per second assumed for a message whose dbc gives no cycle time
+constexpr double ARENA_DEFAULT_RATE = 10.0;
+// largest single buffer, offsets into a buffer stay 32 bit
+constexpr size_t ARENA_BUFFER_MAX = size_t{1} << 30;
+// frames per chunk of a blocked message, a page holds a whole number of chunk columns
+constexpr uint32_t ARENA_CHUNK_FRAMES = 64;
+// typed capacities are whole multiples of this many pages, so a bit column ends on a page
+constexpr uint32_t ARENA_COLUMN_GRANULE = 64;
+// each level of a signal's min/max/mean pyramid has buckets ARENA_LOD_FACTOR times wider
+// than the level below, 1:16, 1:256 and 1:4096 frames
+constexpr uint32_t ARENA_LOD_FACTOR = 16;
+constexpr uint32_t ARENA_LOD_LEVELS = 3;
+// every level holds a buffer's frames / ARENA_LOD_SHARE buckets, so level k spans
+// ARENA_LOD_FACTOR^(k + 1) / ARENA_LOD_SHARE of the hot window, a quarter up to 64 of them
+constexpr uint32_t ARENA_LOD_SHARE = 64;
+// frames between two checkpoints of a message's time index, see Arena::timeBound
+constexpr uint32_t ARENA_INDEX_FRAMES = 64;
+// frames of a raw or typed signal its decode window holds, see Arena::decode
+constexpr uint32_t ARENA_DECODE_FRAMES = 8192;
+
+// dbc, canp and socketcan all mark 29 bit ids with bit 31
+constexpr uint32_t CAN_EXTENDED_FLAG = 0x80000000;
+constexpr uint32_t CAN_EXTENDED_MASK = 0x1FFFFFFF;
+
+constexpr bool validMessageId(uint32_t id) {
+  return (id & ~CAN_EXTENDED_FLAG) <= CAN_EXTENDED_MASK;
+}
+
+// messages are keyed by (bus, id), the bus sits in bits 29 and 30 which no can id uses
+constexpr uint32_t CAN_BUS_MAX = 4;
+constexpr uint32_t CAN_BUS_SHIFT = 29;
+constexpr uint32_t CAN_BUS_MASK = (CAN_BUS_MAX - 1) << CAN_BUS_SHIFT;
+
+constexpr uint32_t messageKey(uint32_t bus, uint32_t id) { return id | (bus << CAN_BUS_SHIFT); }
+constexpr uint32_t messageBus(uint32_t key) { return (key & CAN_BUS_MASK) >> CAN_BUS_SHIFT; }
+constexpr uint32_t messageCanId(uint32_t key) { return key & ~CAN_BUS_MASK; }
 
 enum datatype { vINT = 0, vFLOAT = 1, vDOUBLE = 2 };
 
+enum class DecodeKind : uint8_t { Invalid = 0, Unsigned, Signed, Float, Double };
+
+// precomputed at dbc load so the ingest path never re-derives the bit layout
+// the whole 8 byte payload is one word, so the byte offset folds into shift
+struct DecodePlan {
+  uint64_t mask{};
+  double scale = 1.0;
+  double offset = 0.0;
+  uint8_t shift{};
+  uint8_t signShift{};
+  uint8_t minDlc{};
+  bool bswap{};
+  DecodeKind kind = DecodeKind::Invalid;
+};
+
+// how a typed arena stores one signal, values are the undecoded field and read back as
+// value * scale + offset, Float64 is what every other arena stores
+enum class ColumnType : uint8_t {
+  Float64 = 0,
+  Bit,
+  Int8,
+  UInt8,
+  Int16,
+  UInt16,
+  Int32,
+  UInt32,
+  Float32,
+};
+
+constexpr uint32_t columnBits(ColumnType column) {
+  switch (column) {
+    case ColumnType::Bit:
+      return 1;
+    case ColumnType::Int8:
+    case ColumnType::UInt8:
+      return 8;
+    case ColumnType::Int16:
+    case ColumnType::UInt16:
+      return 16;
+    case ColumnType::Int32:
+    case ColumnType::UInt32:
+    case ColumnType::Float32:
+      return 32;
+    case ColumnType::Float64:
+    default:
+      return 64;
+  }
+}
+
+template <typename T>
+constexpr ColumnType columnTypeOf() {
+  if constexpr (std::is_same_v<T, int8_t>) return ColumnType::Int8;
+  if constexpr (std::is_same_v<T, uint8_t>) return ColumnType::UInt8;
+  if constexpr (std::is_same_v<T, int16_t>) return ColumnType::Int16;
+  if constexpr (std::is_same_v<T, uint16_t>) return ColumnType::UInt16;
+  if constexpr (std::is_same_v<T, int32_t>) return ColumnType::Int32;
+  if constexpr (std::is_same_v<T, uint32_t>) return ColumnType::UInt32;
+  if constexpr (std::is_same_v<T, float>) return ColumnType::Float32;
+  return ColumnType::Float64;
+}
+
+// one multiplexed message, signalCounts[i] signals are stored under multiplexor value values[i]
+// multiplexor is the position of the multiplexor among the message's own signals
+struct MuxConfig {
+  uint32_t multiplexor{};
+  bool tapped{};
+  std::vector<uint32_t> values{};
+  std::vector<uint32_t> signalCounts{};
+  std::vector<std::vector<ColumnType>> columns{};
+};
+
+// signalCounts[i], mux[i] and rates[i] belong to validIds[i]
+// mux may be left empty when nothing is multiplexed
+// rates are expected frames per second, empty or 0 means ARENA_DEFAULT_RATE
+// retention is the seconds every buffer should hold at its rate, arenaSize grows to fit it
+// ring asks for wraparound buffers, init falls back to linear ones where they cannot be mapped
+// blocked stores each message as chunks of ARENA_CHUNK_FRAMES frames instead of one buffer
+// per column, see FrameChunk
+// raw stores each frame's payload word instead of its signals, signals decode when read,
+// a raw message is never blocked
+// typed stores every signal at its columns[i] width, missing types are Float64, doubles
+// are decoded from the column when read as for raw, a typed message is never blocked
+// session backs a ring arena with that file instead of a memfd, reopen maps what an
+// earlier session left in it rather than starting empty, see session.hpp
 struct arenaConfig {
   size_t arenaSize{};
-  std::array<uint32_t, MESSAGE_MAX> signalCounts{};
+  std::vector<uint32_t> signalCounts{};
   std::vector<uint32_t> validIds{};
+  std::vector<MuxConfig> mux{};
+  std::vector<double> rates{};
+  std::vector<std::vector<ColumnType>> columns{};
+  double retention{};
+  bool ring{};
+  bool blocked{};
+  bool raw{};
+  bool typed{};
+  std::string session{};
+  bool reopen{};
+};
+
+// one bucket of a signal's pyramid, float is finer than any pixel it is drawn to
+struct LodBucket {
+  float min{};
+  float max{};
+  float mean{};
 };
 
 struct Signal {
@@ -28,12 +174,31 @@ struct Signal {
   double offset = 0.0;
   double min = 0.0;
   double max = 0.0;
-  std::string name = "NULL";
-  std::string unit = "NULL";
-  std::string receiver = "NULL";
+  // names point into the arena's string pool
+  const char* name = "NULL";
+  const char* unit = "NULL";
+  const char* receiver = "NULL";
+  DecodePlan plan{};
+  // a raw or typed signal's data is its decode window, frame cachedFrom first, guarded by
+  // Arena::decodeMutex
   void* data{};
+  uint64_t cachedFrom{};
+  uint64_t cachedTo{};
+  // native width storage of a typed message, one value per frame, bit i of byte i / 8
+  // for Bit columns
+  ColumnType column = ColumnType::Float64;
+  void* columnData{};
+  // ARENA_LOD_LEVELS rings of Message::lodBuckets buckets, level k first, see Arena::foldLod
+  // lodSum is the running sum of the newest bucket of each level
+  LodBucket* lod{};
+  std::array<double, ARENA_LOD_LEVELS> lodSum{};
 };
 
+// build time specialized decoder for one message, see dbc.hpp
+// signal i of count frames lands in columns[i * stride, i * stride + count)
+using MessageDecodeFn = void (*)(const uint64_t* words, const uint64_t* swapped, uint32_t count,
+                                 double* columns, uint32_t stride);
+
 struct alignas(64) PublishedSize {
   std::atomic<uint32_t> value{};
 };
@@ -41,42 +206,342 @@ struct alignas(64) PublishedSize {
 static_assert(sizeof(PublishedSize) == 64);
 static_assert(alignof(PublishedSize) == 64);
 
+// bytes appended since the last clear and the oldest of them still held, shared by every
+// buffer of a message, a linear arena never moves tail and a ring arena moves it before
+// overwriting, readers see [tail, head)
+// writers reserve from reserved and publish in reservation order, committed is where the
+// next writer may publish, it follows head once that writer's latest and pyramid are done
+struct alignas(64) RingCounters {
+  std::atomic<uint64_t> head{};
+  std::atomic<uint64_t> tail{};
+  std::atomic<uint64_t> reserved{};
+  std::atomic<uint64_t> committed{};
+};
+
+// the newest frame of a message, published with a seqlock by whoever appends to it
+// sequence is odd while a frame is being written and sequence / 2 frames have been published
+// the fields are atomics so a reader racing the writer is torn rather than undefined
+struct alignas(64) LatestFrame {
+  std::atomic<uint64_t> sequence{};
+  std::atomic<double> time{};
+  std::array<std::atomic<double>, SIGNAL_MAX> values{};
+};
+
+// a consistent copy of a LatestFrame, updates is 0 until the first frame arrives
+struct LatestSnapshot {
+  uint64_t updates{};
+  double time{};
+  uint32_t count{};
+  std::array<double, SIGNAL_MAX> values{};
+};
+
+// a signal found by name once per dbc load, message is its position in the arena's
+// message store so mux group signals resolve as well, see Arena::resolve
+// a handle only means something to the arena generation that resolved it
+struct SignalHandle {
+  uint32_t message = UINT32_MAX;
+  uint32_t signal{};
+  uint64_t generation{};
+};
+
 struct Message {
+  // message key, see messageKey
   uint32_t id{};
+  uint32_t bus{};
+  // position in validIds, dense so per message ui state can be a flat array
+  uint32_t index{};
   uint32_t dlc{};
   uint32_t signalCount{};
-  std::string name{};
-  std::string transmitter{};
+  uint8_t minDlc{};
+  bool decodable{};
+  MessageDecodeFn decode{};
+  const char* name = "";
+  const char* transmitter = "";
+  // bytes in each of this message's buffers, sized from rate
+  uint32_t capacity{};
+  double rate{};
+  // bytes per chunk of a blocked message, 0 when every column has a buffer of its own
+  // a blocked message's timeData is its chunk store and signal i starts i + 1 columns in
+  uint32_t chunkStride{};
+  // payload words of a raw message, one per frame at the same offset as its time,
+  // signals are decoded into a window of windowFrames off the pool when read
+  void* payloadData{};
+  // signals live in their columnData, data is a decode window as for raw
+  bool typed{};
+  uint32_t windowFrames{};
+  // stored bits per frame over every column, time included
+  uint32_t frameBits{};
+  // buckets per pyramid level and the time of each bucket's first frame, level k first
+  // frames before lodFrame are folded in, frames before lodResume were dropped unfolded
+  uint32_t lodBuckets{};
+  double* lodTime{};
+  std::atomic<uint64_t> lodFrame{};
+  uint64_t lodResume{};
+  // the time of every ARENA_INDEX_FRAMES-th frame, checkpoint k in slot k % indexSlots
+  // enough slots that a ring retires a checkpoint before its slot is reused
+  uint32_t indexSlots{};
+  double* timeIndex{};
   PublishedSize signalSize{};
+  RingCounters counters{};
+  // kept across clears, a dashboard keeps showing the last value it saw
+  LatestFrame latest{};
   void* timeData{};
   std::array<Signal*, SIGNAL_MAX> signals{};
+  // multiplexed messages keep the multiplexor and plain signals here and every multiplexor
+  // value in a group of its own, groups are sorted by muxValue and never enter the index
+  // a tapped pack repeats the same signals in every group, one group per tap
+  uint32_t muxSignal{};
+  uint32_t muxCount{};
+  uint32_t muxValue{};
+  bool tapped{};
+  Message* muxGroups{};
+
+  Message* muxGroup(uint32_t value) const {
+    Message* end = muxGroups + muxCount;
+    Message* group = std::lower_bound(muxGroups, end, value,
+                                      [](const Message& m, uint32_t v) { return m.muxValue < v; });
+    return group != end && group->muxValue == value ? group : nullptr;
+  }
+};
+
+// one tap of an array valued signal, time and values are size bytes long
+struct TapSeries {
+  const double* time{};
+  const double* values{};
+  uint32_t size{};
+};
+
+// count frames of one message starting at frame first, time and every signal column are
+// count contiguous doubles, a columnar message yields its whole window as one chunk
+struct FrameChunk {
+  const Message* msg{};
+  uint64_t first{};
+  uint32_t count{};
+  const double* time{};
+
+  // signal columns sit at the same distance from their buffer as time does from timeData
+  // raw and typed signals have no such column, they are read through Arena::gather
+  const double* signal(uint32_t i) const {
+    if (i >= msg->signalCount || !msg->signals[i]) return nullptr;
+    if (msg->payloadData || msg->typed) return nullptr;
+    return static_cast<const double*>(msg->signals[i]->data) +
+           (time - static_cast<const double*>(msg->timeData));
+  }
+  // raw messages only
+  const uint64_t* payload() const {
+    if (!msg->payloadData) return nullptr;
+    return static_cast<const uint64_t*>(msg->payloadData) +
+           (time - static_cast<const double*>(msg->timeData));
+  }
+};
+
+// walks a snapshot of [tail, head) oldest first, see Arena::chunks
+// a ring arena may overwrite chunks still ahead of the cursor, compare first to the tail
+// when that matters
+struct ChunkCursor {
+  const Message* msg{};
+  uint64_t frame{};
+  uint64_t end{};
+  bool ring{};
+
+  bool next(FrameChunk& chunk);
+};
+
+// the stored column of a typed signal over [tail, head) of one snapshot, frame i is
+// values[i] * scale + offset at time[i]
+template <typename T>
+struct ColumnRun {
+  std::span<const T> values{};
+  const double* time{};
+  double scale = 1.0;
+  double offset = 0.0;
 };
 
+// a Bit column over [tail, head), frame i is bit firstBit + i of bytes
+struct BitRun {
+  const uint8_t* bytes{};
+  uint64_t firstBit{};
+  uint32_t count{};
+  const double* time{};
+  double scale = 1.0;
+  double offset = 0.0;
+
+  bool operator[](uint32_t i) const {
+    const uint64_t bit = firstBit + i;
+    return (bytes[bit >> 3] >> (bit & 7)) & 1;
+  }
+};
+
+// columns of Arena::readLod, one entry per frame, bucket or run of buckets drawn
+// a single frame has min, max and mean equal
+struct LodColumns {
+  std::span<double> time{};
+  std::span<double> min{};
+  std::span<double> max{};
+  std::span<double> mean{};
+};
+
+// open addressing table over the loaded ids, rebuilt on every dbc load
+// build searches for a multiplier that puts every id in its home slot,
+// so a lookup is one multiply, one shift and one compare
+struct MessageIndex {
+  static constexpr uint32_t EMPTY = UINT32_MAX;
+  struct Slot {
+    uint32_t id = EMPTY;
+    Message* msg{};
+  };
+
+  std::vector<Slot> slots{};
+  uint32_t multiplier{};
+  uint32_t shift{};
+  uint32_t mask{};
+  uint32_t maxProbe{};
+
+  uint32_t home(uint32_t id) const { return (id * multiplier) >> shift; }
+  Message* find(uint32_t id) const {
+    if (slots.empty()) return nullptr;
+    uint32_t slot = home(id);
+    for (uint32_t probe = 0; probe <= maxProbe; probe++, slot = (slot + 1) & mask)
+      if (slots[slot].id == id) return slots[slot].msg;
+    return nullptr;
+  }
+  void build(const std::vector<Message*>& messages);
+  void clear();
+};
+
+struct SessionHeader;
+
 struct Arena {
   void* pool{};
   uint8_t* cursor{};
   size_t remaining{};
   size_t totalPages{};
-  size_t pagesPerBuffer{};
-  size_t bytesPerBuffer{};
+  // bytes handed to signal and time buffers, the rest of the pool is slack
+  size_t capacityBytes{};
+  double retention{};
   size_t arenaSize = {};
   uint32_t totalSignals = {};
   uint32_t totalTimeBuffers = {};
   uint32_t totalBuffers = {};
   uint64_t generation = {};
+  // every buffer is its memfd slice mapped twice back to back, so [tail, head) never splits
+  bool ring{};
+  int ringFd = -1;
+  // where the buffers start in ringFd, past the header of a session file
+  size_t ringOffset{};
+  // the file and its mapped header and trailer when ringFd is a session
+  std::string session{};
+  SessionHeader* sessionHeader{};
+  uint8_t* sessionTrailer{};
+  size_t sessionTrailerBytes{};
+  bool blocked{};
+  bool raw{};
+  bool typed{};
+  std::mutex decodeMutex{};
+  // raw and typed pyramids are folded off the ingest thread, see Arena::foldPending
+  std::mutex lodMutex{};
   std::vector<uint32_t> validIds{};
-  std::array<Message*, MESSAGE_MAX> messages{};
+  MessageIndex messages{};
+  std::unique_ptr<Message[]> messageStore{};
+  // messages and then their mux groups in messageStore
+  uint32_t storedMessages{};
+  std::unique_ptr<Signal[]> signalStore{};
+  std::unique_ptr<double[]> lodTimeStore{};
+  std::unique_ptr<LodBucket[]> lodStore{};
+  std::unique_ptr<double[]> indexStore{};
+  std::unique_ptr<double[]> windowStore{};
+  // interned names of the loaded dbc, one copy shared by every message and signal
+  std::string strings{};
+  // frames of old each stored message holds after copyFrom, catchUp resumes from there
+  std::vector<uint64_t> copiedFrames{};
+  // set while a resized arena is published but not caught up yet, appenders wait it out
+  std::atomic<bool> catchingUp{};
 
   void init(const arenaConfig& config);
+  Message* message(uint32_t id) const { return messages.find(id); }
+  SignalHandle resolve(std::string_view name) const;
+  const Message* message(const SignalHandle& handle) const;
   void* alloc(size_t bytes, size_t align);
+  void* allocBuffer(size_t bytes);
+  void snapshot(const Message& msg, uint64_t& tail, uint64_t& head) const;
+  void window(const Message& msg, void* buffer, void** data, uint32_t* size) const;
+  void signalWindow(const Message& msg, uint32_t signal, void** data, uint32_t* size);
+  ChunkCursor chunks(const Message& msg, uint64_t newest = UINT64_MAX) const;
+  uint64_t timeBound(const Message& msg, uint64_t first, uint64_t end, double time,
+                     bool after) const;
+  ChunkCursor timeRange(const Message& msg, double from, double to) const;
+  uint32_t offset(const Message& msg, uint64_t bytes) const {
+    return static_cast<uint32_t>(ring ? bytes % msg.capacity : bytes);
+  }
+  bool beginAppend(Message& msg, size_t bytes, uint64_t& start);
+  void endAppend(Message& msg, uint64_t start, size_t bytes, const double* time = nullptr,
+                 const double* values = nullptr, uint32_t stride = 1);
+  void restore(Message& msg, uint64_t head, uint64_t tail);
   void read(uint32_t id, uint32_t signal, void** data, uint32_t* size);
+  uint32_t read(uint32_t id, uint32_t signal, uint32_t count, const double** values,
+                const double** times);
+  uint32_t readRange(uint32_t id, uint32_t signal, double from, double to, const double** values,
+                     const double** times);
+  bool readAsOf(uint32_t id, uint32_t signal, double time, double& value, double* stamp = nullptr);
   bool write(uint32_t id, uint32_t signal, void* data, uint32_t size);
   void readTime(uint32_t id, void** data, uint32_t* size);
-  bool writeTime(uint32_t id, void* data, uint32_t size);
   bool appendFrame(uint32_t id, double timeValue, const double* signalValues, uint32_t signalCount);
+  bool appendFrames(uint32_t id, const double* timeValues, const double* columns, uint32_t stride,
+                    uint32_t frameCount);
+  bool appendFrames(Message& msg, const double* timeValues, const double* columns,
+                    uint32_t stride, uint32_t frameCount);
+  bool appendPayloads(Message& msg, const double* timeValues, const uint64_t* words,
+                      uint32_t frameCount);
+  void publishLatest(Message& msg, double time, const double* values, uint32_t stride);
+  bool latest(const Message& msg, LatestSnapshot& out) const;
+  bool latest(const SignalHandle& handle, double& value, double* time = nullptr) const;
+  const double* decode(const Message& msg, uint32_t signal, uint64_t& first, uint64_t end);
+  void gather(const Message& msg, uint32_t signal, uint64_t first, uint64_t end,
+              double* out) const;
+  template <typename T>
+  bool readColumn(uint32_t id, uint32_t signal, ColumnRun<T>& run) const;
+  bool readBits(uint32_t id, uint32_t signal, BitRun& run) const;
+  void foldLod(Message& msg, uint64_t end);
+  void foldPending();
+  uint32_t readLod(uint32_t id, uint32_t signal, double from, double to, uint32_t pixels,
+                   const LodColumns& out);
+  Message* muxGroup(uint32_t id, uint32_t value) const;
+  void readMux(uint32_t id, uint32_t value, uint32_t signal, void** data, uint32_t* size);
+  void readMuxTime(uint32_t id, uint32_t value, void** data, uint32_t* size);
+  uint32_t readTaps(uint32_t id, uint32_t signal, std::span<TapSeries> taps);
+  uint32_t latestTaps(uint32_t id, uint32_t signal, std::span<double> values) const;
+  double measuredRate(const Message& msg) const;
+  arenaConfig layout() const;
+  void copyFrom(const Arena& old);
+  void catchUp(const Arena& old);
+  void copyFrames(Message& to, const Arena& old, const Message& from, ChunkCursor cursor);
+  void copyColumns(Message& to, const Message& from, const FrameChunk& chunk);
   void clear(uint32_t signal);
+  bool clear(Message& msg);
   void destroy();
 
   void status();
   void statusUI(int flags);
 };
+
+// T has to match the signal's ColumnType exactly, Bit columns are read through readBits
+template <typename T>
+bool Arena::readColumn(uint32_t id, uint32_t signal, ColumnRun<T>& run) const {
+  static_assert(!std::is_same_v<T, bool>, "bit columns are read through readBits");
+  run = {};
+  const Message* msg = message(id);
+  if (!msg || !msg->typed || signal >= msg->signalCount || !msg->signals[signal]) return false;
+  const Signal& sig = *msg->signals[signal];
+  if (sig.column != columnTypeOf<T>() || !sig.columnData) return false;
+  uint64_t tail = 0;
+  uint64_t head = 0;
+  snapshot(*msg, tail, head);
+  const uint64_t first = tail / sizeof(double);
+  const uint64_t slot = ring ? first % (msg->capacity / sizeof(double)) : first;
+  run.values = {static_cast<const T*>(sig.columnData) + slot,
+                static_cast<size_t>((head - tail) / sizeof(double))};
+  run.time = static_cast<const double*>(msg->timeData) + slot;
+  run.scale = sig.scale;
+  run.offset = sig.offset;
+  return true;
+}
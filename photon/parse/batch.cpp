@@ -0,0 +1,244 @@
+#include "batch.hpp"
+
+#include <bit>
+#include <cstdint>
+
+#include "arena.hpp"
+#include "decode.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define PHOTON_DECODE_AVX2 1
+#include <cpuid.h>
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define PHOTON_DECODE_NEON 1
+#include <arm_neon.h>
+#endif
+
+using GatherFn = void (*)(const uint8_t*, size_t, const uint16_t*, uint32_t, DecodeLanes&);
+using DecodeFn = void (*)(const DecodePlan&, const uint64_t*, uint32_t, uint32_t, double*);
+
+struct DecodeBackend {
+  const char* name;
+  GatherFn gather;
+  DecodeFn decode;
+};
+
+void gatherScalar(const uint8_t* base, size_t stride, const uint16_t* rows, uint32_t count,
+                  DecodeLanes& lanes) {
+  for (uint32_t i = 0; i < count; i++) {
+    lanes.words[i] = loadPayload(base + rows[i] * stride);
+    lanes.swapped[i] = std::byteswap(lanes.words[i]);
+  }
+  lanes.count = count;
+}
+
+// decodes lanes [first, count) one at a time
+void decodeScalar(const DecodePlan& plan, const uint64_t* src, uint32_t first, uint32_t count,
+                  double* out) {
+  for (uint32_t i = first; i < count; i++) {
+    const uint64_t raw = (src[i] >> plan.shift) & plan.mask;
+    switch (plan.kind) {
+      case DecodeKind::Unsigned:
+        out[i] = static_cast<double>(raw) * plan.scale + plan.offset;
+        break;
+      case DecodeKind::Signed:
+        out[i] = static_cast<double>(static_cast<int64_t>(raw << plan.signShift) >>
+                                     plan.signShift) *
+                     plan.scale +
+                 plan.offset;
+        break;
+      case DecodeKind::Float:
+        out[i] = static_cast<double>(std::bit_cast<float>(static_cast<uint32_t>(raw))) *
+                     plan.scale +
+                 plan.offset;
+        break;
+      case DecodeKind::Double:
+        out[i] = std::bit_cast<double>(raw) * plan.scale + plan.offset;
+        break;
+      case DecodeKind::Invalid:
+      default:
+        out[i] = 0.0;
+        break;
+    }
+  }
+}
+
+#ifdef PHOTON_DECODE_AVX2
+bool cpuHasAvx2() {
+  unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+  const bool fma = (ecx & (1u << 12)) != 0;
+  const bool osxsave = (ecx & (1u << 27)) != 0;
+  const bool avx = (ecx & (1u << 28)) != 0;
+  if (!fma || !osxsave || !avx) return false;
+
+  // the os has to save ymm state across context switches
+  uint32_t xcr0Low = 0, xcr0High = 0;
+  __asm__ volatile("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+  if ((xcr0Low & 0x6u) != 0x6u) return false;
+
+  if (__get_cpuid_max(0, nullptr) < 7) return false;
+  __cpuid_count(7, 0, eax, ebx, ecx, edx);
+  return (ebx & (1u << 5)) != 0;
+}
+
+__attribute__((target("avx2,fma"))) void gatherAvx2(const uint8_t* base, size_t stride,
+                                                     const uint16_t* rows, uint32_t count,
+                                                     DecodeLanes& lanes) {
+  const __m256i reverse = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                           7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+  const __m256i strideVec = _mm256_set1_epi64x(static_cast<long long>(stride));
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256i index =
+        _mm256_cvtepu16_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(rows + i)));
+    index = _mm256_mul_epu32(index, strideVec);
+    const __m256i word =
+        _mm256_i64gather_epi64(reinterpret_cast<const long long*>(base), index, 1);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes.words + i), word);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes.swapped + i),
+                       _mm256_shuffle_epi8(word, reverse));
+  }
+  for (; i < count; i++) {
+    lanes.words[i] = loadPayload(base + rows[i] * stride);
+    lanes.swapped[i] = std::byteswap(lanes.words[i]);
+  }
+  lanes.count = count;
+}
+
+// integers up to 52 bits convert exactly through the 2^52 exponent trick
+__attribute__((target("avx2,fma"))) inline __m256d toDoubleAvx2(__m256i value) {
+  const __m256i exponent = _mm256_set1_epi64x(0x4330000000000000ll);
+  const __m256d bias = _mm256_set1_pd(4503599627370496.0);
+  return _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(value, exponent)), bias);
+}
+
+__attribute__((target("avx2,fma"))) void decodeAvx2(const DecodePlan& plan, const uint64_t* src,
+                                                     uint32_t first, uint32_t count,
+                                                     double* out) {
+  const uint32_t length = 64u - plan.signShift;
+  const bool integer = plan.kind == DecodeKind::Unsigned || plan.kind == DecodeKind::Signed;
+  if (plan.kind == DecodeKind::Invalid || (integer && length > 52)) {
+    decodeScalar(plan, src, first, count, out);
+    return;
+  }
+
+  const __m128i shift = _mm_cvtsi32_si128(plan.shift);
+  const __m256i mask = _mm256_set1_epi64x(static_cast<long long>(plan.mask));
+  const __m256d scale = _mm256_set1_pd(plan.scale);
+  const __m256d offset = _mm256_set1_pd(plan.offset);
+  // signed values are biased into [0, 2^length) and the bias removed exactly as a double
+  const uint64_t signBit = integer ? uint64_t{1} << (length - 1) : 0;
+  const __m256i signVec = _mm256_set1_epi64x(static_cast<long long>(signBit));
+  const __m256d signBias = _mm256_set1_pd(static_cast<double>(signBit));
+  const __m256i lowDwords = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+
+  uint32_t i = first;
+  for (; i + 4 <= count; i += 4) {
+    __m256i raw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    raw = _mm256_and_si256(_mm256_srl_epi64(raw, shift), mask);
+    __m256d value;
+    switch (plan.kind) {
+      case DecodeKind::Signed:
+        value = _mm256_sub_pd(toDoubleAvx2(_mm256_xor_si256(raw, signVec)), signBias);
+        break;
+      case DecodeKind::Float:
+        value = _mm256_cvtps_pd(_mm_castsi128_ps(
+            _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(raw, lowDwords))));
+        break;
+      case DecodeKind::Double:
+        value = _mm256_castsi256_pd(raw);
+        break;
+      case DecodeKind::Unsigned:
+      default:
+        value = toDoubleAvx2(raw);
+        break;
+    }
+    _mm256_storeu_pd(out + i, _mm256_fmadd_pd(value, scale, offset));
+  }
+  decodeScalar(plan, src, i, count, out);
+}
+#endif
+
+#ifdef PHOTON_DECODE_NEON
+void decodeNeon(const DecodePlan& plan, const uint64_t* src, uint32_t first, uint32_t count,
+                double* out) {
+  if (plan.kind == DecodeKind::Invalid) {
+    decodeScalar(plan, src, first, count, out);
+    return;
+  }
+
+  const int64x2_t shift = vdupq_n_s64(-static_cast<int64_t>(plan.shift));
+  const int64x2_t signUp = vdupq_n_s64(plan.signShift);
+  const int64x2_t signDown = vdupq_n_s64(-static_cast<int64_t>(plan.signShift));
+  const uint64x2_t mask = vdupq_n_u64(plan.mask);
+  const float64x2_t scale = vdupq_n_f64(plan.scale);
+  const float64x2_t offset = vdupq_n_f64(plan.offset);
+
+  uint32_t i = first;
+  for (; i + 2 <= count; i += 2) {
+    const uint64x2_t raw = vandq_u64(vshlq_u64(vld1q_u64(src + i), shift), mask);
+    float64x2_t value;
+    switch (plan.kind) {
+      case DecodeKind::Signed:
+        value = vcvtq_f64_s64(vshlq_s64(vshlq_s64(vreinterpretq_s64_u64(raw), signUp), signDown));
+        break;
+      case DecodeKind::Float:
+        value = vcvt_f64_f32(vreinterpret_f32_u32(vmovn_u64(raw)));
+        break;
+      case DecodeKind::Double:
+        value = vreinterpretq_f64_u64(raw);
+        break;
+      case DecodeKind::Unsigned:
+      default:
+        value = vcvtq_f64_u64(raw);
+        break;
+    }
+    vst1q_f64(out + i, vfmaq_f64(offset, value, scale));
+  }
+  decodeScalar(plan, src, i, count, out);
+}
+#endif
+
+// picks the widest decoder the running cpu supports, once
+const DecodeBackend& decodeBackend() {
+  static const DecodeBackend backend = [] {
+#ifdef PHOTON_DECODE_AVX2
+    if (cpuHasAvx2()) return DecodeBackend{"avx2", gatherAvx2, decodeAvx2};
+#endif
+#ifdef PHOTON_DECODE_NEON
+    return DecodeBackend{"neon", gatherScalar, decodeNeon};
+#endif
+    return DecodeBackend{"scalar", gatherScalar, decodeScalar};
+  }();
+  return backend;
+}
+
+void gatherLanes(const uint8_t* base, size_t stride, const uint16_t* rows, uint32_t count,
+                 DecodeLanes& lanes) {
+  if (count > DECODE_LANES_MAX) count = DECODE_LANES_MAX;
+  decodeBackend().gather(base, stride, rows, count, lanes);
+}
+
+void decodeLanes(const DecodePlan& plan, const DecodeLanes& lanes, double* out) {
+  decodeBackend().decode(plan, plan.bswap ? lanes.swapped : lanes.words, 0, lanes.count, out);
+}
+
+void decodeMessageLanes(const Message& msg, const DecodeLanes& lanes, double* columns,
+                        uint32_t stride) {
+  if (msg.decode) {
+    msg.decode(lanes.words, lanes.swapped, lanes.count, columns, stride);
+    return;
+  }
+  const DecodeBackend& backend = decodeBackend();
+  for (uint32_t i = 0; i < msg.signalCount; i++) {
+    const Signal* sig = msg.signals[i];
+    if (!sig) continue;
+    const DecodePlan& plan = sig->plan;
+    backend.decode(plan, plan.bswap ? lanes.swapped : lanes.words, 0, lanes.count,
+                   columns + static_cast<size_t>(i) * stride);
+  }
+}
+
+const char* decodeBackendName() { return decodeBackend().name; }
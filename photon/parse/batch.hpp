@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "arena.hpp"
+
+constexpr uint32_t DECODE_LANES_MAX = 64;
+
+// payload words of every frame of one message in a batch
+// swapped holds the byte reversed words for motorola signals
+struct DecodeLanes {
+  uint32_t count{};
+  alignas(32) uint64_t words[DECODE_LANES_MAX]{};
+  alignas(32) uint64_t swapped[DECODE_LANES_MAX]{};
+};
+
+// gathers the 8 byte payloads at base + rows[i] * stride into lanes
+void gatherLanes(const uint8_t* base, size_t stride, const uint16_t* rows, uint32_t count,
+                 DecodeLanes& lanes);
+
+// decodes one signal across every lane, dlc must already be checked against the plan
+void decodeLanes(const DecodePlan& plan, const DecodeLanes& lanes, double* out);
+
+// decodes every signal of msg, signal i lands in columns[i * stride, i * stride + count)
+void decodeMessageLanes(const Message& msg, const DecodeLanes& lanes, double* columns,
+                        uint32_t stride);
+
+const char* decodeBackendName();
@@ -0,0 +1,308 @@
+// dbcbench <dbc directory> [iterations]
+// times parseDBC over every .dbc in the directory, the file is mapped once and parsed in place
+// then decoding each file's signals against the per bit loop the plans replaced, and appending
+// to the built in car arena against the single writer path appends took before
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../batch.hpp"
+#include "../dbc.hpp"
+#include "../decode.hpp"
+#include "../mapped.hpp"
+#include "../parse.hpp"
+
+// frames decoded per pass, payloads are random so every bit of every signal moves
+constexpr uint32_t BENCH_DECODE_FRAMES = 4096;
+// frames per append, one canp batch
+constexpr uint32_t BENCH_APPEND_FRAMES = 64;
+constexpr uint32_t BENCH_APPEND_BATCHES = 4096;
+
+template <typename Fn>
+double bestOf(int iterations, Fn&& fn) {
+  double best = 1e30;
+  for (int i = 0; i < iterations; i++) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    best = std::min(best, std::chrono::duration<double>(elapsed).count());
+  }
+  return best;
+}
+
+// the per bit decoder signals used before decode plans, kept as the baseline
+bool extractSignalRaw(const uint8_t data[8], uint8_t dlc, const Signal& sig, uint64_t& raw) {
+  raw = 0;
+  if (sig.startBit < 0 || sig.length <= 0 || sig.length > 64 || dlc > 8) return false;
+
+  const int availableBits = static_cast<int>(dlc) * 8;
+  if (sig.endianness == 1) {
+    if (sig.startBit + sig.length > availableBits) return false;
+    for (int i = 0; i < sig.length; i++) {
+      const int bit = sig.startBit + i;
+      raw |= static_cast<uint64_t>((data[bit / 8] >> (bit % 8)) & 0x1u) << i;
+    }
+    return true;
+  }
+
+  int bit = sig.startBit;
+  for (int i = 0; i < sig.length; i++) {
+    if (bit < 0 || bit >= availableBits) return false;
+    raw = (raw << 1) | static_cast<uint64_t>((data[bit / 8] >> (bit % 8)) & 0x1u);
+    bit = (bit % 8 == 0) ? bit + 15 : bit - 1;
+  }
+  return true;
+}
+
+int64_t signExtend(uint64_t raw, int bits) {
+  if (bits <= 0 || bits >= 64) return static_cast<int64_t>(raw);
+
+  const uint64_t signBit = uint64_t{1} << (bits - 1);
+  const uint64_t mask = (uint64_t{1} << bits) - 1;
+  raw &= mask;
+  if ((raw & signBit) != 0) raw |= ~mask;
+  return static_cast<int64_t>(raw);
+}
+
+bool decodeSignalValue(const uint8_t data[8], uint8_t dlc, const Signal& sig, double& value) {
+  uint64_t raw = 0;
+  if (!extractSignalRaw(data, dlc, sig, raw)) return false;
+
+  switch (sig.type) {
+    case vFLOAT: {
+      if (sig.length != 32) return false;
+      const auto bits = static_cast<uint32_t>(raw);
+      value = static_cast<double>(std::bit_cast<float>(bits)) * sig.scale + sig.offset;
+      return true;
+    }
+    case vDOUBLE: {
+      if (sig.length != 64) return false;
+      value = std::bit_cast<double>(raw) * sig.scale + sig.offset;
+      return true;
+    }
+    case vINT:
+    default: {
+      const double parsed = sig.isSigned ? static_cast<double>(signExtend(raw, sig.length))
+                                         : static_cast<double>(raw);
+      value = parsed * sig.scale + sig.offset;
+      return true;
+    }
+  }
+}
+
+// every signal of the file over the same random frames, one column of values per signal
+void benchDecode(const std::filesystem::path& path, const DbcModel& model, int iterations) {
+  std::vector<Signal> signals{};
+  for (const DbcSignal& desc : model.signals) {
+    Signal sig{};
+    sig.startBit = desc.startBit;
+    sig.length = desc.length;
+    sig.endianness = desc.endianness;
+    sig.type = desc.type;
+    sig.isSigned = desc.isSigned;
+    sig.scale = desc.scale;
+    sig.offset = desc.offset;
+    sig.plan = buildDecodePlan(sig);
+    signals.push_back(sig);
+  }
+  if (signals.empty()) return;
+
+  std::mt19937_64 random{1};
+  std::vector<uint64_t> payloads(BENCH_DECODE_FRAMES);
+  for (uint64_t& payload : payloads) payload = random();
+  const auto* bytes = reinterpret_cast<const uint8_t*>(payloads.data());
+  const size_t values = signals.size() * BENCH_DECODE_FRAMES;
+  std::vector<double> loop(values);
+  std::vector<double> plan(values);
+  std::vector<double> lanes(values);
+
+  const double loopSeconds = bestOf(iterations, [&] {
+    for (uint32_t f = 0; f < BENCH_DECODE_FRAMES; f++)
+      for (size_t s = 0; s < signals.size(); s++)
+        if (!decodeSignalValue(bytes + f * 8, 8, signals[s], loop[s * BENCH_DECODE_FRAMES + f]))
+          loop[s * BENCH_DECODE_FRAMES + f] = 0.0;
+  });
+  const double planSeconds = bestOf(iterations, [&] {
+    for (uint32_t f = 0; f < BENCH_DECODE_FRAMES; f++) {
+      const uint64_t word = loadPayload(bytes + f * 8);
+      const uint64_t swapped = std::byteswap(word);
+      for (size_t s = 0; s < signals.size(); s++)
+        if (!decodeSignal(signals[s].plan, word, swapped, 8, plan[s * BENCH_DECODE_FRAMES + f]))
+          plan[s * BENCH_DECODE_FRAMES + f] = 0.0;
+    }
+  });
+  std::array<uint16_t, DECODE_LANES_MAX> rows{};
+  for (uint32_t i = 0; i < DECODE_LANES_MAX; i++) rows[i] = static_cast<uint16_t>(i);
+  DecodeLanes batch{};
+  const double lanesSeconds = bestOf(iterations, [&] {
+    for (uint32_t f = 0; f < BENCH_DECODE_FRAMES; f += DECODE_LANES_MAX) {
+      gatherLanes(bytes + f * 8, 8, rows.data(), DECODE_LANES_MAX, batch);
+      for (size_t s = 0; s < signals.size(); s++) {
+        double* out = lanes.data() + s * BENCH_DECODE_FRAMES + f;
+        if (signals[s].plan.kind == DecodeKind::Invalid)
+          std::fill_n(out, DECODE_LANES_MAX, 0.0);
+        else
+          decodeLanes(signals[s].plan, batch, out);
+      }
+    }
+  });
+
+  // the same bits either way, nan payloads of float signals compare by their bits
+  size_t mismatches = 0;
+  for (size_t i = 0; i < values; i++)
+    mismatches += std::bit_cast<uint64_t>(loop[i]) != std::bit_cast<uint64_t>(plan[i]) ||
+                  std::bit_cast<uint64_t>(loop[i]) != std::bit_cast<uint64_t>(lanes[i]);
+
+  const auto perValue = [&](double seconds) { return seconds * 1e9 / static_cast<double>(values); };
+  std::printf("%-32s %8zu %10.2f %10.2f %10.2f %8.1fx %8.1fx %10zu\n",
+              path.filename().string().c_str(), signals.size(), perValue(loopSeconds),
+              perValue(planSeconds), perValue(lanesSeconds), loopSeconds / planSeconds,
+              loopSeconds / lanesSeconds, mismatches);
+}
+
+// the single writer append a columnar message took before several writers could share it,
+// head is the only counter it publishes through, kept as the baseline
+bool appendSingle(Arena& arena, Message& msg, const double* times, const double* columns,
+                  uint32_t stride, uint32_t count) {
+  const size_t bytes = size_t{count} * sizeof(double);
+  const uint64_t head = msg.counters.head.load(std::memory_order_relaxed);
+  if (bytes > msg.capacity || (!arena.ring && head + bytes > msg.capacity)) return false;
+  const uint64_t tail = msg.counters.tail.load(std::memory_order_relaxed);
+  if (arena.ring && head + bytes - tail > msg.capacity) {
+    msg.counters.tail.store(head + bytes - msg.capacity, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  const uint32_t offset = arena.offset(msg, head);
+  std::memcpy(static_cast<uint8_t*>(msg.timeData) + offset, times, bytes);
+  for (uint32_t i = 0; i < msg.signalCount; i++)
+    std::memcpy(static_cast<uint8_t*>(msg.signals[i]->data) + offset,
+                columns + size_t{i} * stride, bytes);
+
+  const uint64_t first = head / sizeof(double);
+  const uint64_t end = first + count;
+  if (msg.timeIndex)
+    for (uint64_t checkpoint = (first + ARENA_INDEX_FRAMES - 1) / ARENA_INDEX_FRAMES;
+         checkpoint * ARENA_INDEX_FRAMES < end; checkpoint++)
+      msg.timeIndex[checkpoint % msg.indexSlots] = times[checkpoint * ARENA_INDEX_FRAMES - first];
+  const uint64_t published = head + bytes;
+  msg.counters.head.store(published, std::memory_order_release);
+  msg.signalSize.value.store(
+      static_cast<uint32_t>(published - msg.counters.tail.load(std::memory_order_relaxed)),
+      std::memory_order_release);
+  arena.foldLod(msg, UINT64_MAX);
+  if (count) arena.publishLatest(msg, times[count - 1], columns + count - 1, stride);
+  return true;
+}
+
+// one writer appending canp sized batches to the widest columnar message of the car arena
+void benchAppend(int iterations) {
+  Parse parse{};
+  if (!parse.loadDBC(DBCType::Car)) {
+    std::fprintf(stderr, "dbcbench: could not load the car dbc\n");
+    return;
+  }
+  Arena& arena = *parse.published.load();
+  Message* widest = nullptr;
+  for (uint32_t id : arena.validIds) {
+    Message* msg = arena.message(id);
+    if (!msg->timeData || msg->chunkStride || msg->payloadData || msg->typed) continue;
+    if (!widest || msg->signalCount > widest->signalCount) widest = msg;
+  }
+  if (!widest) return;
+  Message& msg = *widest;
+
+  std::vector<double> times(BENCH_APPEND_FRAMES);
+  std::vector<double> columns(size_t{BENCH_APPEND_FRAMES} * msg.signalCount);
+  for (size_t i = 0; i < columns.size(); i++) columns[i] = static_cast<double>(i % 977);
+  double clock = 0.0;
+  auto stamp = [&] {
+    for (double& time : times) time = clock += 1e-3;
+  };
+
+  const double current = bestOf(iterations, [&] {
+    arena.clear(msg);
+    for (uint32_t b = 0; b < BENCH_APPEND_BATCHES; b++) {
+      stamp();
+      arena.appendFrames(msg, times.data(), columns.data(), BENCH_APPEND_FRAMES,
+                         BENCH_APPEND_FRAMES);
+    }
+  });
+  const double single = bestOf(iterations, [&] {
+    arena.clear(msg);
+    for (uint32_t b = 0; b < BENCH_APPEND_BATCHES; b++) {
+      stamp();
+      appendSingle(arena, msg, times.data(), columns.data(), BENCH_APPEND_FRAMES,
+                   BENCH_APPEND_FRAMES);
+    }
+    // hands the message back to the shared counters so the next clear takes it
+    const uint64_t head = msg.counters.head.load(std::memory_order_relaxed);
+    msg.counters.reserved.store(head, std::memory_order_relaxed);
+    msg.counters.committed.store(head, std::memory_order_release);
+  });
+
+  const double frames = double{BENCH_APPEND_FRAMES} * BENCH_APPEND_BATCHES;
+  std::printf("\n%-32s %8s %12s %12s %8s\n", "append", "sigs", "shared Mf/s", "single Mf/s",
+              "ratio");
+  std::printf("%-32s %8u %12.2f %12.2f %8.2f\n", msg.name, msg.signalCount,
+              frames / current / 1e6, frames / single / 1e6, single / current);
+  parse.destroy();
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::fprintf(stderr, "usage: dbcbench <dbc directory> [iterations]\n");
+    return 1;
+  }
+  const int iterations = argc > 2 ? std::max(1, std::atoi(argv[2])) : 200;
+
+  std::vector<std::filesystem::path> paths{};
+  std::error_code ec{};
+  for (const auto& entry : std::filesystem::directory_iterator(argv[1], ec)) {
+    if (!entry.is_regular_file() || entry.path().extension() != ".dbc") continue;
+    paths.push_back(entry.path());
+  }
+  std::sort(paths.begin(), paths.end());
+  if (paths.empty()) {
+    std::fprintf(stderr, "dbcbench: no .dbc files in %s\n", argv[1]);
+    return 1;
+  }
+
+  std::printf("%-32s %10s %8s %8s %12s %10s\n", "file", "bytes", "msgs", "sigs", "parse us",
+              "MB/s");
+  double totalSeconds = 0.0;
+  size_t totalBytes = 0;
+  std::vector<DbcModel> models(paths.size());
+  for (size_t p = 0; p < paths.size(); p++) {
+    MappedFile file{};
+    if (!file.open(paths[p].string())) continue;
+
+    DbcModel& model = models[p];
+    const double best = bestOf(iterations, [&] { parseDBC(file.view(), model); });
+
+    totalSeconds += best;
+    totalBytes += file.size;
+    std::printf("%-32s %10zu %8zu %8zu %12.1f %10.1f\n", paths[p].filename().string().c_str(),
+                file.size, model.messages.size(), model.signals.size(), best * 1e6,
+                static_cast<double>(file.size) / best / 1e6);
+  }
+  std::printf("%-32s %10zu %8s %8s %12.1f %10.1f\n", "total", totalBytes, "", "",
+              totalSeconds * 1e6, static_cast<double>(totalBytes) / totalSeconds / 1e6);
+
+  // ns per decoded value, and how many times faster than the bit loop
+  const int passes = std::max(1, iterations / 10);
+  std::printf("\n%-32s %8s %10s %10s %10s %9s %9s %10s\n", "decode", "sigs", "loop ns",
+              "plan ns", "lanes ns", "plan", "lanes", "mismatch");
+  for (size_t p = 0; p < paths.size(); p++) benchDecode(paths[p], models[p], passes);
+
+  benchAppend(passes);
+  return 0;
+}
@@ -0,0 +1,194 @@
+// dbcgen <input.dbc> <output.hpp> <namespace>
+// compiles a dbc into constexpr tables and one specialized decoder per message
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+#include "../arena.hpp"
+#include "../dbc.hpp"
+#include "../mapped.hpp"
+
+std::string escapeStrings(std::string_view strings) {
+  std::string out = "\"";
+  size_t column = 0;
+  for (const char ch : strings) {
+    const auto c = static_cast<unsigned char>(ch);
+    char buffer[8];
+    if (c == '"' || c == '\\') {
+      std::snprintf(buffer, sizeof(buffer), "\\%c", ch);
+    } else if (c < 0x20 || c >= 0x7f) {
+      std::snprintf(buffer, sizeof(buffer), "\\%03o", c);
+    } else {
+      buffer[0] = ch;
+      buffer[1] = '\0';
+    }
+    out += buffer;
+    column += std::string_view(buffer).size();
+    if (c == '\0' && column > 80) {
+      out += "\"\n    \"";
+      column = 0;
+    }
+  }
+  out += "\"";
+  return out;
+}
+
+const char* muxName(MuxRole mux) {
+  switch (mux) {
+    case MuxRole::Multiplexor:
+      return "MuxRole::Multiplexor";
+    case MuxRole::Multiplexed:
+      return "MuxRole::Multiplexed";
+    case MuxRole::None:
+    default:
+      return "MuxRole::None";
+  }
+}
+
+const char* sendTypeName(SendType sendType) {
+  switch (sendType) {
+    case SendType::Cyclic:
+      return "SendType::Cyclic";
+    case SendType::Event:
+      return "SendType::Event";
+    case SendType::CyclicAndEvent:
+      return "SendType::CyclicAndEvent";
+    case SendType::CyclicAndEventNoRepetition:
+      return "SendType::CyclicAndEventNoRepetition";
+    case SendType::None:
+      return "SendType::None";
+    case SendType::Spontaneous:
+      return "SendType::Spontaneous";
+    case SendType::Unknown:
+    default:
+      return "SendType::Unknown";
+  }
+}
+
+const char* typeName(datatype type) {
+  switch (type) {
+    case vFLOAT:
+      return "vFLOAT";
+    case vDOUBLE:
+      return "vDOUBLE";
+    case vINT:
+    default:
+      return "vINT";
+  }
+}
+
+std::string generate(const DbcModel& model, std::string_view input, std::string_view ns) {
+  std::string out;
+  char line[512];
+
+  out += "// generated by dbcgen from ";
+  out += input;
+  out += ", do not edit\n#pragma once\n#include <array>\n\n#include \"dbc.hpp\"\n\n";
+  out += "namespace ";
+  out += ns;
+  out += " {\n\n";
+
+  out += "inline constexpr char strings[] =\n    " + escapeStrings(model.strings) + ";\n\n";
+
+  std::snprintf(line, sizeof(line), "inline constexpr std::array<DbcSignal, %zu> signals{{\n",
+                model.signals.size());
+  out += line;
+  for (const DbcSignal& sig : model.signals) {
+    std::snprintf(line, sizeof(line),
+                  "    {.name = %u, .unit = %u, .receiver = %u, .startBit = %d, .length = %d,\n"
+                  "     .endianness = %d, .type = %s, .isSigned = %s, .scale = %.17g,\n"
+                  "     .offset = %.17g, .min = %.17g, .max = %.17g, .firstValue = %u,\n"
+                  "     .valueCount = %u, .mux = %s, .muxValue = %u},\n",
+                  sig.name, sig.unit, sig.receiver, sig.startBit, sig.length, sig.endianness,
+                  typeName(sig.type), sig.isSigned ? "true" : "false", sig.scale, sig.offset,
+                  sig.min, sig.max, sig.firstValue, sig.valueCount, muxName(sig.mux),
+                  sig.muxValue);
+    out += line;
+  }
+  out += "}};\n\n";
+
+  std::snprintf(line, sizeof(line), "inline constexpr std::array<DbcValue, %zu> values{{\n",
+                model.values.size());
+  out += line;
+  for (const DbcValue& value : model.values) {
+    std::snprintf(line, sizeof(line), "    {.raw = %lldll, .label = %u},\n",
+                  static_cast<long long>(value.raw), value.label);
+    out += line;
+  }
+  out += "}};\n\n";
+
+  std::snprintf(line, sizeof(line), "inline constexpr std::array<DbcMessage, %zu> messages{{\n",
+                model.messages.size());
+  out += line;
+  for (const DbcMessage& msg : model.messages) {
+    std::snprintf(line, sizeof(line),
+                  "    {.id = %uu, .dlc = %u, .name = %u, .transmitter = %u, .firstSignal = %u,\n"
+                  "     .signalCount = %u, .cycleTime = %u, .sendType = %s},\n",
+                  msg.id, msg.dlc, msg.name, msg.transmitter, msg.firstSignal, msg.signalCount,
+                  msg.cycleTime, sendTypeName(msg.sendType));
+    out += line;
+  }
+  out += "}};\n\n";
+
+  std::snprintf(line, sizeof(line),
+                "inline constexpr std::array<MessageDecodeFn, %zu> decoders{{\n",
+                model.messages.size());
+  out += line;
+  for (const DbcMessage& msg : model.messages) {
+    // multiplexed messages split their signals across groups and decode through plans
+    if (dbcMuxLayout(model.view(), msg).multiplexor >= 0) {
+      out += "    nullptr,\n";
+      continue;
+    }
+    const uint32_t count = std::min(msg.signalCount, SIGNAL_MAX);
+    std::snprintf(line, sizeof(line), "    decodeStatic<signals, %u, %u>,\n", msg.firstSignal,
+                  count);
+    out += line;
+  }
+  out += "}};\n\n";
+
+  out +=
+      "inline constexpr DbcView view{\n"
+      "    .messages = messages,\n"
+      "    .signals = signals,\n"
+      "    .values = values,\n"
+      "    .strings = {strings, sizeof(strings) - 1},\n"
+      "    .decoders = decoders,\n"
+      "};\n\n";
+  out += "}  // namespace ";
+  out += ns;
+  out += "\n";
+  return out;
+}
+
+int main(int argc, char** argv) {
+  if (argc != 4) {
+    std::fprintf(stderr, "usage: dbcgen <input.dbc> <output.hpp> <namespace>\n");
+    return 1;
+  }
+
+  MappedFile file{};
+  if (!file.open(argv[1])) {
+    std::fprintf(stderr, "dbcgen: cannot read %s\n", argv[1]);
+    return 1;
+  }
+
+  DbcModel model{};
+  parseDBC(file.view(), model);
+  file.close();
+
+  const std::string_view input = argv[1];
+  const size_t slash = input.find_last_of("/\\");
+  const std::string header =
+      generate(model, slash == std::string_view::npos ? input : input.substr(slash + 1), argv[3]);
+
+  std::ofstream out(argv[2], std::ios::binary | std::ios::trunc);
+  if (!out) {
+    std::fprintf(stderr, "dbcgen: cannot write %s\n", argv[2]);
+    return 1;
+  }
+  out << header;
+  return out ? 0 : 1;
+}
@@ -0,0 +1,565 @@
+#include "cold.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <numeric>
+
+// ticks per second a time column may be stored in, canp stamps whole milliseconds
+constexpr std::array<double, 3> coldTickScales{1e3, 1e6, 1e9};
+constexpr uint32_t COLD_RUN_BITS = std::bit_width(COLD_BLOCK_FRAMES - 1);
+
+// msb first, so a column reads back in the order it was written
+struct BitWriter {
+  std::vector<uint8_t>& out;
+  uint64_t pending{};
+  uint32_t bits{};
+
+  void write(uint64_t value, uint32_t count) {
+    if (count > 32) {
+      write(value >> 32, count - 32);
+      value &= 0xFFFFFFFFu;
+      count = 32;
+    }
+    pending = (pending << count) | (value & ((uint64_t{1} << count) - 1));
+    bits += count;
+    while (bits >= 8) {
+      bits -= 8;
+      out.push_back(static_cast<uint8_t>(pending >> bits));
+    }
+    pending &= (uint64_t{1} << bits) - 1;
+  }
+  void flush() {
+    if (bits) out.push_back(static_cast<uint8_t>(pending << (8 - bits)));
+    pending = 0;
+    bits = 0;
+  }
+};
+
+struct BitReader {
+  const uint8_t* data{};
+  size_t size{};
+  size_t bit{};
+
+  // reads past the end as zeros
+  uint64_t read(uint32_t count) {
+    uint64_t value = 0;
+    while (count) {
+      const size_t byte = bit >> 3;
+      if (byte >= size) return count >= 64 ? 0 : value << count;
+      const uint32_t available = 8 - static_cast<uint32_t>(bit & 7);
+      const uint32_t take = std::min(available, count);
+      value = (value << take) | ((data[byte] >> (available - take)) & ((1u << take) - 1));
+      count -= take;
+      bit += take;
+    }
+    return value;
+  }
+};
+
+// gorilla: an unchanged value is one bit, otherwise the xor's meaningful bits are written
+// inside the previous leading/trailing zero window when they fit, or with a new window
+struct XorEncoder {
+  BitWriter& out;
+  uint64_t previous{};
+  uint32_t leading = UINT32_MAX;
+  uint32_t trailing{};
+  bool started{};
+
+  void put(uint64_t value) {
+    if (!started) {
+      out.write(value, 64);
+      previous = value;
+      started = true;
+      return;
+    }
+    const uint64_t x = value ^ previous;
+    previous = value;
+    if (!x) {
+      out.write(0, 1);
+      return;
+    }
+    out.write(1, 1);
+    const auto lead = std::min<uint32_t>(std::countl_zero(x), 31);
+    const auto trail = static_cast<uint32_t>(std::countr_zero(x));
+    if (leading != UINT32_MAX && lead >= leading && trail >= trailing) {
+      out.write(0, 1);
+      out.write(x >> trailing, 64 - leading - trailing);
+      return;
+    }
+    leading = lead;
+    trailing = trail;
+    const uint32_t significant = 64 - lead - trail;
+    out.write(1, 1);
+    out.write(lead, 5);
+    out.write(significant - 1, 6);
+    out.write(x >> trail, significant);
+  }
+};
+
+struct XorDecoder {
+  BitReader& in;
+  uint64_t previous{};
+  uint32_t leading{};
+  uint32_t trailing{};
+  bool started{};
+
+  uint64_t get() {
+    if (!started) {
+      previous = in.read(64);
+      started = true;
+      return previous;
+    }
+    if (!in.read(1)) return previous;
+    if (in.read(1)) {
+      leading = static_cast<uint32_t>(in.read(5));
+      const auto significant = static_cast<uint32_t>(in.read(6)) + 1;
+      trailing = 64 - leading - significant;
+    }
+    previous ^= in.read(64 - leading - trailing) << trailing;
+    return previous;
+  }
+};
+
+// the coarsest tick every time of the block is an exact multiple of, -1 when there is none
+int tickScale(const double* values, uint32_t count) {
+  for (size_t s = 0; s < coldTickScales.size(); s++) {
+    const double scale = coldTickScales[s];
+    bool exact = true;
+    for (uint32_t i = 0; i < count && exact; i++) {
+      const double scaled = values[i] * scale;
+      if (!(std::fabs(scaled) < 9e18)) {
+        exact = false;
+        break;
+      }
+      const double back = static_cast<double>(std::llround(scaled)) / scale;
+      exact = std::bit_cast<uint64_t>(back) == std::bit_cast<uint64_t>(values[i]);
+    }
+    if (exact) return static_cast<int>(s);
+  }
+  return -1;
+}
+
+// a zero delta of delta is one bit, small ones a prefix and 7, 9 or 12 bits, zigzagged
+void encodeTicks(const double* values, uint32_t count, int scaleIndex,
+                 std::vector<uint8_t>& out) {
+  out.push_back(static_cast<uint8_t>(ColdCodec::Ticks));
+  out.push_back(static_cast<uint8_t>(scaleIndex));
+  const double scale = coldTickScales[scaleIndex];
+  BitWriter bits{out};
+  uint64_t previous = 0;
+  uint64_t previousDelta = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    const auto tick = static_cast<uint64_t>(std::llround(values[i] * scale));
+    if (i == 0) {
+      bits.write(tick, 64);
+      previous = tick;
+      continue;
+    }
+    const uint64_t delta = tick - previous;
+    const uint64_t dod = delta - previousDelta;
+    const uint64_t zigzag = (dod << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(dod) >> 63);
+    if (zigzag == 0) {
+      bits.write(0b0, 1);
+    } else if (zigzag < (1u << 7)) {
+      bits.write(0b10, 2);
+      bits.write(zigzag, 7);
+    } else if (zigzag < (1u << 9)) {
+      bits.write(0b110, 3);
+      bits.write(zigzag, 9);
+    } else if (zigzag < (1u << 12)) {
+      bits.write(0b1110, 4);
+      bits.write(zigzag, 12);
+    } else {
+      bits.write(0b1111, 4);
+      bits.write(zigzag, 64);
+    }
+    previous = tick;
+    previousDelta = delta;
+  }
+  bits.flush();
+}
+
+void encodeXor(const double* values, uint32_t count, std::vector<uint8_t>& out) {
+  out.push_back(static_cast<uint8_t>(ColdCodec::Xor));
+  BitWriter bits{out};
+  XorEncoder encoder{bits};
+  for (uint32_t i = 0; i < count; i++) encoder.put(std::bit_cast<uint64_t>(values[i]));
+  bits.flush();
+}
+
+// each run is its value, xor'd against the last run's, and its length less one
+void encodeRle(const double* values, uint32_t count, std::vector<uint8_t>& out) {
+  out.push_back(static_cast<uint8_t>(ColdCodec::Rle));
+  BitWriter bits{out};
+  XorEncoder encoder{bits};
+  for (uint32_t i = 0; i < count;) {
+    const uint64_t value = std::bit_cast<uint64_t>(values[i]);
+    uint32_t end = i + 1;
+    while (end < count && std::bit_cast<uint64_t>(values[end]) == value) end++;
+    encoder.put(value);
+    bits.write(end - i - 1, COLD_RUN_BITS);
+    i = end;
+  }
+  bits.flush();
+}
+
+// times take ticks whenever they are whole ones, any column takes runs when they are
+// shorter than its xor stream
+void encodeColumn(const double* values, uint32_t count, bool time, std::vector<uint8_t>& out) {
+  if (time) {
+    const int scale = tickScale(values, count);
+    if (scale >= 0) {
+      encodeTicks(values, count, scale, out);
+      return;
+    }
+  }
+  uint32_t runs = 1;
+  for (uint32_t i = 1; i < count; i++)
+    runs += std::bit_cast<uint64_t>(values[i]) != std::bit_cast<uint64_t>(values[i - 1]);
+
+  const size_t start = out.size();
+  encodeXor(values, count, out);
+  if (runs * 8 > count) return;
+  std::vector<uint8_t> rle{};
+  encodeRle(values, count, rle);
+  if (rle.size() >= out.size() - start) return;
+  out.resize(start);
+  out.insert(out.end(), rle.begin(), rle.end());
+}
+
+void decodeColumn(const uint8_t* data, size_t size, uint32_t count, double* out) {
+  if (size == 0) {
+    std::fill_n(out, count, 0.0);
+    return;
+  }
+  const auto codec = static_cast<ColdCodec>(data[0]);
+  BitReader bits{data + 1, size - 1};
+  switch (codec) {
+    case ColdCodec::Ticks: {
+      const double scale = coldTickScales[std::min<size_t>(data[1], coldTickScales.size() - 1)];
+      bits = {data + 2, size - 2};
+      uint64_t tick = 0;
+      uint64_t delta = 0;
+      for (uint32_t i = 0; i < count; i++) {
+        if (i == 0) {
+          tick = bits.read(64);
+        } else {
+          uint64_t zigzag = 0;
+          if (!bits.read(1))
+            zigzag = 0;
+          else if (!bits.read(1))
+            zigzag = bits.read(7);
+          else if (!bits.read(1))
+            zigzag = bits.read(9);
+          else if (!bits.read(1))
+            zigzag = bits.read(12);
+          else
+            zigzag = bits.read(64);
+          delta += (zigzag >> 1) ^ (~(zigzag & 1) + 1);
+          tick += delta;
+        }
+        out[i] = static_cast<double>(static_cast<int64_t>(tick)) / scale;
+      }
+      return;
+    }
+    case ColdCodec::Rle: {
+      XorDecoder decoder{bits};
+      for (uint32_t i = 0; i < count;) {
+        const double value = std::bit_cast<double>(decoder.get());
+        const uint32_t run = std::min<uint32_t>(static_cast<uint32_t>(bits.read(COLD_RUN_BITS)) + 1,
+                                                count - i);
+        std::fill_n(out + i, run, value);
+        i += run;
+      }
+      return;
+    }
+    case ColdCodec::Xor:
+    default: {
+      XorDecoder decoder{bits};
+      for (uint32_t i = 0; i < count; i++) out[i] = std::bit_cast<double>(decoder.get());
+      return;
+    }
+  }
+}
+
+size_t blockBytes(const ColdBlock& block) {
+  return sizeof(ColdBlock) + block.bytes.size() + block.columns.size() * sizeof(uint32_t) +
+         block.summary.size() * sizeof(LodBucket);
+}
+
+// column i of a block, time when i is 0
+void decodeBlockColumn(const ColdBlock& block, uint32_t i, double* out) {
+  const size_t start = block.columns[i];
+  const size_t end = i + 1 < block.columns.size() ? block.columns[i + 1] : block.bytes.size();
+  decodeColumn(block.bytes.data() + start, end - start, block.count, out);
+}
+
+// the first held frame of msg stamped after time, where sealing picks up after a resize
+uint64_t firstAfter(const Arena& arena, const Message& msg, double time) {
+  const ChunkCursor cursor = arena.chunks(msg);
+  return arena.timeBound(msg, cursor.frame, cursor.end, time, true);
+}
+
+// compresses frames [first, first + COLD_BLOCK_FRAMES) of msg, false when a ring overwrote
+// any of them while they were copied out, or a clear dropped them
+bool sealBlock(Arena& arena, const Message& msg, uint64_t first, ColdBlock& block,
+               double& lastTime) {
+  const uint64_t end = first + COLD_BLOCK_FRAMES;
+  std::array<double, COLD_BLOCK_FRAMES> column{};
+  ChunkCursor cursor{&msg, first, end, arena.ring};
+  FrameChunk chunk{};
+  for (uint32_t done = 0; cursor.next(chunk); done += chunk.count)
+    std::memcpy(column.data() + done, chunk.time, chunk.count * sizeof(double));
+
+  block = {};
+  block.count = COLD_BLOCK_FRAMES;
+  block.columns.reserve(msg.signalCount + 1);
+  block.summary.reserve(msg.signalCount);
+  const auto [lo, hi] = std::minmax_element(column.begin(), column.end());
+  block.minTime = *lo;
+  block.maxTime = *hi;
+  lastTime = column.back();
+  block.columns.push_back(0);
+  encodeColumn(column.data(), COLD_BLOCK_FRAMES, true, block.bytes);
+  for (uint32_t i = 0; i < msg.signalCount; i++) {
+    // gathered rather than decoded, the compactor leaves the readers' decode windows alone
+    arena.gather(msg, i, first, end, column.data());
+    const auto [min, max] = std::minmax_element(column.begin(), column.end());
+    const double sum = std::accumulate(column.begin(), column.end(), 0.0);
+    block.summary.push_back({static_cast<float>(*min), static_cast<float>(*max),
+                             static_cast<float>(sum / COLD_BLOCK_FRAMES)});
+    block.columns.push_back(static_cast<uint32_t>(block.bytes.size()));
+    encodeColumn(column.data(), COLD_BLOCK_FRAMES, false, block.bytes);
+  }
+  block.bytes.shrink_to_fit();
+
+  // the copies above have to land before the counters are checked, as for a seqlock
+  std::atomic_thread_fence(std::memory_order_acquire);
+  uint64_t tail = 0;
+  uint64_t head = 0;
+  arena.snapshot(msg, tail, head);
+  return tail / sizeof(double) <= first && head / sizeof(double) >= end;
+}
+
+// seals every whole block of msg past the last one, returns the frames sealed
+uint64_t compactMessage(ColdStore& store, Arena& arena, const Message& msg, uint64_t key) {
+  if (!msg.timeData) return 0;
+  uint64_t generation = 0;
+  uint64_t next = 0;
+  double lastTime = 0.0;
+  bool sealed = false;
+  {
+    std::unique_lock lock(store.mutex);
+    if (arena.generation < store.generation) return 0;
+    ColdSeries& series = store.series[key];
+    series.signalCount = msg.signalCount;
+    generation = series.generation;
+    next = series.next;
+    lastTime = series.lastTime;
+    sealed = series.sealed;
+  }
+
+  uint64_t tail = 0;
+  uint64_t head = 0;
+  arena.snapshot(msg, tail, head);
+  uint64_t oldest = tail / sizeof(double);
+  uint64_t newest = head / sizeof(double);
+  // a new arena numbers its frames from its own start, a resized one holds the same times
+  if (generation != arena.generation) next = sealed ? firstAfter(arena, msg, lastTime) : oldest;
+  if (next > newest) next = oldest;
+  if (next < oldest) {
+    store.dropped.fetch_add(oldest - next, std::memory_order_relaxed);
+    next = oldest;
+  }
+
+  std::vector<ColdBlock> blocks{};
+  while (newest - next >= COLD_BLOCK_FRAMES) {
+    ColdBlock block{};
+    double blockLast = 0.0;
+    if (sealBlock(arena, msg, next, block, blockLast)) {
+      next += COLD_BLOCK_FRAMES;
+      lastTime = blockLast;
+      blocks.push_back(std::move(block));
+      continue;
+    }
+    arena.snapshot(msg, tail, head);
+    oldest = tail / sizeof(double);
+    newest = head / sizeof(double);
+    // cleared under the copy, the next pass starts over from the new frames
+    if (oldest <= next) break;
+    store.dropped.fetch_add(oldest - next, std::memory_order_relaxed);
+    next = oldest;
+  }
+
+  std::unique_lock lock(store.mutex);
+  if (arena.generation < store.generation) return 0;
+  ColdSeries& series = store.series[key];
+  series.generation = arena.generation;
+  series.next = next;
+  series.lastTime = lastTime;
+  series.sealed = sealed || !blocks.empty();
+  for (ColdBlock& block : blocks) {
+    store.bytes.fetch_add(blockBytes(block), std::memory_order_relaxed);
+    store.rawBytes.fetch_add(uint64_t{block.count} * (series.signalCount + 1) * sizeof(double),
+                             std::memory_order_relaxed);
+    store.frames.fetch_add(block.count, std::memory_order_relaxed);
+    series.blocks.push_back(std::move(block));
+  }
+  return blocks.size() * uint64_t{COLD_BLOCK_FRAMES};
+}
+
+// one pass over every message and mux group of arena, then the oldest blocks over budget go
+uint64_t ColdStore::compact(Arena& arena) {
+  uint64_t sealed = 0;
+  for (const uint32_t id : arena.validIds) {
+    const Message* msg = arena.message(id);
+    if (!msg) continue;
+    sealed += compactMessage(*this, arena, *msg, coldKey(id));
+    for (uint32_t g = 0; g < msg->muxCount; g++) {
+      const Message& group = msg->muxGroups[g];
+      sealed += compactMessage(*this, arena, group, coldKey(id, group.muxValue));
+    }
+  }
+
+  std::unique_lock lock(mutex);
+  while (bytes.load(std::memory_order_relaxed) > budget) {
+    ColdSeries* oldest = nullptr;
+    for (auto& [key, entry] : series)
+      if (!entry.blocks.empty() &&
+          (!oldest || entry.blocks.front().minTime < oldest->blocks.front().minTime))
+        oldest = &entry;
+    if (!oldest) break;
+    bytes.fetch_sub(blockBytes(oldest->blocks.front()), std::memory_order_relaxed);
+    oldest->blocks.pop_front();
+  }
+  return sealed;
+}
+
+// samples of one signal stamped in [from, to], cold ones first then the hot window
+// the cold tier only answers for times before the oldest frame the arena still holds,
+// the hot window is searched through its time index
+uint32_t readSeries(ColdStore& store, Arena& hot, const Message* msg, uint64_t key,
+                    uint32_t signal, double from, double to, std::vector<double>& times,
+                    std::vector<double>& values) {
+  std::vector<double> hotTimes{};
+  std::vector<double> hotValues{};
+  double hotStart = std::numeric_limits<double>::infinity();
+  if (msg && signal < msg->signalCount && msg->signals[signal]) {
+    // one snapshot for both, so no frame falls between the cold and the hot part
+    uint64_t tail = 0;
+    uint64_t head = 0;
+    hot.snapshot(*msg, tail, head);
+    const uint64_t oldest = tail / sizeof(double);
+    const uint64_t newest = head / sizeof(double);
+    FrameChunk chunk{};
+    ChunkCursor held{msg, oldest, newest, hot.ring};
+    if (held.next(chunk)) hotStart = chunk.time[0];
+    const uint64_t first = hot.timeBound(*msg, oldest, newest, from, false);
+    ChunkCursor cursor{msg, first, hot.timeBound(*msg, first, newest, to, true), hot.ring};
+    hotValues.resize(cursor.end - cursor.frame);
+    hot.gather(*msg, signal, cursor.frame, cursor.end, hotValues.data());
+    while (cursor.next(chunk))
+      hotTimes.insert(hotTimes.end(), chunk.time, chunk.time + chunk.count);
+  }
+
+  const size_t before = times.size();
+  {
+    std::shared_lock lock(store.mutex);
+    const auto found = store.series.find(key);
+    if (found != store.series.end() && signal < found->second.signalCount) {
+      std::array<double, COLD_BLOCK_FRAMES> blockTimes{};
+      std::array<double, COLD_BLOCK_FRAMES> blockValues{};
+      for (const ColdBlock& block : found->second.blocks) {
+        if (block.maxTime < from || block.minTime > to || block.minTime >= hotStart) continue;
+        decodeBlockColumn(block, 0, blockTimes.data());
+        decodeBlockColumn(block, signal + 1, blockValues.data());
+        for (uint32_t i = 0; i < block.count; i++) {
+          const double time = blockTimes[i];
+          if (time < from || time > to || time >= hotStart) continue;
+          times.push_back(time);
+          values.push_back(blockValues[i]);
+        }
+      }
+    }
+  }
+  times.insert(times.end(), hotTimes.begin(), hotTimes.end());
+  values.insert(values.end(), hotValues.begin(), hotValues.end());
+  return static_cast<uint32_t>(times.size() - before);
+}
+
+uint32_t ColdStore::read(Arena& hot, uint32_t id, uint32_t signal, double from, double to,
+                         std::vector<double>& times, std::vector<double>& values) {
+  return readSeries(*this, hot, hot.message(id), coldKey(id), signal, from, to, times, values);
+}
+
+uint32_t ColdStore::readMux(Arena& hot, uint32_t id, uint32_t value, uint32_t signal,
+                            double from, double to, std::vector<double>& times,
+                            std::vector<double>& values) {
+  return readSeries(*this, hot, hot.muxGroup(id, value), coldKey(id, value), signal, from, to,
+                    times, values);
+}
+
+// at most pixels columns of one signal over [from, to], one per run of blocks stamped before
+// the hot window, from their summaries, Arena::readLod draws the rest
+uint32_t ColdStore::readLod(const Arena& hot, uint32_t id, uint32_t signal, double from,
+                            double to, uint32_t pixels, const LodColumns& out) {
+  pixels = static_cast<uint32_t>(std::min<size_t>(
+      {pixels, out.time.size(), out.min.size(), out.max.size(), out.mean.size()}));
+  if (pixels == 0) return 0;
+  double hotStart = std::numeric_limits<double>::infinity();
+  if (const Message* msg = hot.message(id)) {
+    ChunkCursor held = hot.chunks(*msg);
+    FrameChunk chunk{};
+    if (held.next(chunk)) hotStart = chunk.time[0];
+  }
+
+  std::shared_lock lock(mutex);
+  const auto found = series.find(coldKey(id));
+  if (found == series.end() || signal >= found->second.signalCount) return 0;
+  // blocks are sealed in append order
+  const std::deque<ColdBlock>& blocks = found->second.blocks;
+  size_t first = 0;
+  while (first < blocks.size() && blocks[first].maxTime < from) first++;
+  size_t end = first;
+  while (end < blocks.size() && blocks[end].minTime <= to && blocks[end].minTime < hotStart)
+    end++;
+  if (first >= end) return 0;
+
+  uint32_t count = 0;
+  const size_t group = (end - first + pixels - 1) / pixels;
+  for (size_t item = first; item < end && count < pixels; item += group, count++) {
+    const size_t last = std::min(item + group, end);
+    double lo = std::numeric_limits<double>::infinity();
+    double hi = -lo;
+    double sum = 0.0;
+    for (size_t b = item; b < last; b++) {
+      if (signal >= blocks[b].summary.size()) continue;
+      const LodBucket& bucket = blocks[b].summary[signal];
+      lo = std::min(lo, static_cast<double>(bucket.min));
+      hi = std::max(hi, static_cast<double>(bucket.max));
+      sum += bucket.mean;
+    }
+    out.time[count] = blocks[item].minTime;
+    out.min[count] = lo;
+    out.max[count] = hi;
+    out.mean[count] = sum / static_cast<double>(last - item);
+  }
+  return count;
+}
+
+// drops every series, blocks still being sealed from an arena before arenaGeneration are
+// dropped when they are committed
+void ColdStore::clear(uint64_t arenaGeneration) {
+  std::unique_lock lock(mutex);
+  series.clear();
+  generation = arenaGeneration;
+  bytes.store(0, std::memory_order_relaxed);
+  rawBytes.store(0, std::memory_order_relaxed);
+  frames.store(0, std::memory_order_relaxed);
+  dropped.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "arena.hpp"
+
+// frames per sealed block, a block is only compressed once all of its frames are appended
+constexpr uint32_t COLD_BLOCK_FRAMES = 1024;
+// compressed bytes kept before the oldest blocks are dropped
+constexpr size_t COLD_DEFAULT_BUDGET = size_t{512} << 20;
+
+// how one column of a block is stored, every column starts with its codec byte
+enum class ColdCodec : uint8_t {
+  // delta of delta over whole ticks, the next byte picks the tick, see coldTickScales
+  Ticks = 0,
+  // gorilla xor against the previous value, lossless for any double
+  Xor,
+  // runs of one value with their lengths, for flags and slowly changing states
+  Rle,
+};
+
+// COLD_BLOCK_FRAMES consecutive frames of one message, each column an independent bit stream
+// column 0 is time and column i + 1 is signal i, columns[i] is where column i starts in bytes
+// times need not be ordered, minTime and maxTime bound every frame
+// summary[i] is signal i over the whole block, so it can be drawn without decoding it
+struct ColdBlock {
+  double minTime{};
+  double maxTime{};
+  uint32_t count{};
+  std::vector<uint32_t> columns{};
+  std::vector<uint8_t> bytes{};
+  std::vector<LodBucket> summary{};
+};
+
+// the compressed history of one message or mux group
+// next is the first frame not yet sealed in the arena of generation, lastTime the time of
+// the frame before it, which finds the same place again in a resized arena
+struct ColdSeries {
+  uint32_t signalCount{};
+  std::deque<ColdBlock> blocks{};
+  uint64_t generation = UINT64_MAX;
+  uint64_t next{};
+  double lastTime{};
+  bool sealed{};
+};
+
+// frames that have left the hot window, or are about to, compressed losslessly
+// compact runs on one background thread, see Parse::compactLoop, reads may come from any
+struct ColdStore {
+  std::shared_mutex mutex{};
+  std::unordered_map<uint64_t, ColdSeries> series{};
+  // blocks sealed from arenas older than this belong to a dbc that is no longer loaded
+  uint64_t generation{};
+  size_t budget = COLD_DEFAULT_BUDGET;
+  std::atomic<uint64_t> bytes{};
+  std::atomic<uint64_t> rawBytes{};
+  std::atomic<uint64_t> frames{};
+  // frames a ring overwrote before they could be sealed
+  std::atomic<uint64_t> dropped{};
+
+  uint64_t compact(Arena& arena);
+  uint32_t read(Arena& hot, uint32_t id, uint32_t signal, double from, double to,
+                std::vector<double>& times, std::vector<double>& values);
+  uint32_t readMux(Arena& hot, uint32_t id, uint32_t value, uint32_t signal, double from,
+                   double to, std::vector<double>& times, std::vector<double>& values);
+  uint32_t readLod(const Arena& hot, uint32_t id, uint32_t signal, double from, double to,
+                   uint32_t pixels, const LodColumns& out);
+  void clear(uint64_t arenaGeneration);
+};
+
+// groups never enter the message index, so their history is keyed by value as well
+constexpr uint64_t coldKey(uint32_t id) { return id; }
+constexpr uint64_t coldKey(uint32_t id, uint32_t muxValue) {
+  return ((uint64_t{muxValue} + 1) << 32) | id;
+}
@@ -0,0 +1,352 @@
+#include "dbc.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+// single pass over the source text, nothing is copied until a name is interned
+struct DbcParser {
+  DbcModel& model;
+  std::unordered_map<std::string_view, uint32_t> interned{};
+  std::unordered_map<uint32_t, uint32_t> messageIndex{};
+  bool haveMsg = false;
+  // message attributes, defaults land on every message without a BA_ of its own
+  std::vector<std::string_view> sendTypeLabels{};
+  std::vector<bool> cycleTimeSet{};
+  std::vector<bool> sendTypeSet{};
+  uint32_t defaultCycleTime{};
+  SendType defaultSendType = SendType::Unknown;
+
+  uint32_t intern(std::string_view text);
+  void parseMessage(std::string_view line);
+  void parseSignal(std::string_view line);
+  void parseValueType(std::string_view line);
+  void parseValues(std::string_view line);
+  DbcSignal* findSignal(uint32_t canId, std::string_view name);
+  void parseAttributeDefinition(std::string_view line);
+  void parseAttributeDefault(std::string_view line);
+  void parseAttribute(std::string_view line);
+  SendType sendType(std::string_view& line);
+  void applyAttributeDefaults();
+};
+
+constexpr bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+std::string_view skipSpace(std::string_view text) {
+  size_t i = 0;
+  while (i < text.size() && isSpace(text[i])) i++;
+  return text.substr(i);
+}
+
+std::string_view nextLine(std::string_view& text) {
+  const size_t end = text.find('\n');
+  const std::string_view line = text.substr(0, end);
+  text = end == std::string_view::npos ? std::string_view{} : text.substr(end + 1);
+  return line;
+}
+
+// whitespace separated, stops early at any of the given delimiters
+std::string_view nextToken(std::string_view& text, std::string_view delimiters = {}) {
+  text = skipSpace(text);
+  size_t i = 0;
+  while (i < text.size() && !isSpace(text[i]) && delimiters.find(text[i]) == std::string_view::npos)
+    i++;
+  const std::string_view token = text.substr(0, i);
+  text = text.substr(i);
+  return token;
+}
+
+bool expect(std::string_view& text, char c) {
+  text = skipSpace(text);
+  if (text.empty() || text.front() != c) return false;
+  text.remove_prefix(1);
+  return true;
+}
+
+template <typename T>
+bool nextNumber(std::string_view& text, T& value) {
+  text = skipSpace(text);
+  if (!text.empty() && text.front() == '+') text.remove_prefix(1);
+  const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+  if (ec != std::errc{}) return false;
+  text.remove_prefix(static_cast<size_t>(end - text.data()));
+  return true;
+}
+
+// "<text>", the quotes are dropped
+bool nextQuoted(std::string_view& text, std::string_view& value) {
+  if (!expect(text, '"')) return false;
+  const size_t quote = text.find('"');
+  if (quote == std::string_view::npos) return false;
+  value = text.substr(0, quote);
+  text.remove_prefix(quote + 1);
+  return true;
+}
+
+SendType sendTypeNamed(std::string_view label) {
+  constexpr std::string_view names[] = {"Cyclic", "Event", "CyclicAndEvent",
+                                        "CyclicAndEventNoRepetition", "None", "Spontaneous"};
+  for (size_t i = 0; i < std::size(names); i++)
+    if (label == names[i]) return static_cast<SendType>(i + 1);
+  return SendType::Unknown;
+}
+
+uint32_t DbcParser::intern(std::string_view text) {
+  const auto it = interned.find(text);
+  if (it != interned.end()) return it->second;
+  const auto offset = static_cast<uint32_t>(model.strings.size());
+  model.strings.append(text);
+  model.strings.push_back('\0');
+  interned.emplace(text, offset);
+  return offset;
+}
+
+// BO_ <id> <name>: <dlc> <transmitter>
+void DbcParser::parseMessage(std::string_view line) {
+  haveMsg = false;
+  uint32_t canId = 0;
+  uint32_t dlc = 0;
+  if (!nextNumber(line, canId)) return;
+  const std::string_view name = nextToken(line, ":");
+  if (!expect(line, ':') || !nextNumber(line, dlc)) return;
+  const std::string_view transmitter = nextToken(line);
+
+  haveMsg = true;
+  messageIndex.try_emplace(canId, static_cast<uint32_t>(model.messages.size()));
+  model.messages.push_back({
+      .id = canId,
+      .dlc = dlc,
+      .name = intern(name),
+      .transmitter = intern(transmitter),
+      .firstSignal = static_cast<uint32_t>(model.signals.size()),
+      .signalCount = 0,
+  });
+}
+
+// SG_ <name> [mux] : <start>|<length>@<endianness><sign> (<scale>,<offset>) [<min>|<max>]
+// "<unit>" <receivers>
+void DbcParser::parseSignal(std::string_view line) {
+  DbcSignal sig{};
+  std::string_view unit = "NULL";
+  std::string_view receiver = "NULL";
+  const std::string_view name = nextToken(line, ":");
+  // M, m<value> or m<value>M, the last nests a multiplexor and is kept as multiplexed
+  const std::string_view indicator = nextToken(line, ":");
+  if (indicator == "M") {
+    sig.mux = MuxRole::Multiplexor;
+  } else if (indicator.size() > 1 && indicator.front() == 'm') {
+    std::string_view value = indicator.substr(1);
+    if (nextNumber(value, sig.muxValue)) sig.mux = MuxRole::Multiplexed;
+  }
+  const size_t colon = line.find(':');
+
+  if (colon != std::string_view::npos) {
+    line.remove_prefix(colon + 1);
+    char sign = '+';
+    if (nextNumber(line, sig.startBit) && expect(line, '|') && nextNumber(line, sig.length) &&
+        expect(line, '@') && !line.empty()) {
+      sig.endianness = line.front() - '0';
+      line.remove_prefix(1);
+      if (!line.empty()) {
+        sign = line.front();
+        line.remove_prefix(1);
+      }
+    }
+    sig.isSigned = sign == '-';
+    if (expect(line, '(')) {
+      nextNumber(line, sig.scale);
+      expect(line, ',');
+      nextNumber(line, sig.offset);
+      expect(line, ')');
+    }
+    if (expect(line, '[')) {
+      nextNumber(line, sig.min);
+      expect(line, '|');
+      nextNumber(line, sig.max);
+      expect(line, ']');
+    }
+    if (expect(line, '"')) {
+      const size_t quote = line.find('"');
+      unit = line.substr(0, quote);
+      line = quote == std::string_view::npos ? std::string_view{} : line.substr(quote + 1);
+    }
+    const std::string_view receivers = nextToken(line);
+    if (!receivers.empty()) receiver = receivers;
+  }
+
+  sig.name = intern(name);
+  sig.unit = intern(unit);
+  sig.receiver = intern(receiver);
+  model.signals.push_back(sig);
+  model.messages.back().signalCount++;
+}
+
+DbcSignal* DbcParser::findSignal(uint32_t canId, std::string_view name) {
+  const auto it = messageIndex.find(canId);
+  if (it == messageIndex.end()) return nullptr;
+  const DbcMessage& msg = model.messages[it->second];
+  for (uint32_t i = 0; i < msg.signalCount; i++) {
+    DbcSignal& sig = model.signals[msg.firstSignal + i];
+    if (name == model.strings.c_str() + sig.name) return &sig;
+  }
+  return nullptr;
+}
+
+// SIG_VALTYPE_ <id> <name> : <type>;
+void DbcParser::parseValueType(std::string_view line) {
+  uint32_t canId = 0;
+  uint32_t rawType = 0;
+  if (!nextNumber(line, canId)) return;
+  const std::string_view name = nextToken(line, ":");
+  if (!expect(line, ':') || !nextNumber(line, rawType)) return;
+
+  DbcSignal* sig = findSignal(canId, name);
+  if (!sig) return;
+  sig->type = vINT;
+  if (rawType == 1) sig->type = vFLOAT;
+  if (rawType == 2) sig->type = vDOUBLE;
+}
+
+// VAL_ <id> <name> <raw> "<label>" ... ;
+void DbcParser::parseValues(std::string_view line) {
+  uint32_t canId = 0;
+  if (!nextNumber(line, canId)) return;
+  DbcSignal* sig = findSignal(canId, nextToken(line));
+  if (!sig) return;
+
+  sig->firstValue = static_cast<uint32_t>(model.values.size());
+  sig->valueCount = 0;
+  DbcValue value{};
+  while (nextNumber(line, value.raw) && expect(line, '"')) {
+    const size_t quote = line.find('"');
+    value.label = intern(line.substr(0, quote));
+    model.values.push_back(value);
+    sig->valueCount++;
+    if (quote == std::string_view::npos) break;
+    line.remove_prefix(quote + 1);
+  }
+}
+
+DbcMuxLayout dbcMuxLayout(const DbcView& dbc, const DbcMessage& msg) {
+  DbcMuxLayout layout{};
+  for (uint32_t i = 0; i < msg.signalCount; i++) {
+    const DbcSignal& sig = dbc.signals[msg.firstSignal + i];
+    if (sig.mux == MuxRole::Multiplexor && layout.multiplexor < 0)
+      layout.multiplexor = static_cast<int32_t>(i);
+    if (sig.mux == MuxRole::Multiplexed) layout.values.push_back(sig.muxValue);
+  }
+  for (uint32_t i = 0; i < msg.signalCount; i++) {
+    const DbcSignal& sig = dbc.signals[msg.firstSignal + i];
+    const std::string_view name = dbc.string(sig.name);
+    const auto pack = std::find_if(std::begin(DBC_TAP_PACKS), std::end(DBC_TAP_PACKS),
+                                   [&](const DbcTapPack& tap) { return tap.signal == name; });
+    if (pack == std::end(DBC_TAP_PACKS)) continue;
+    // no more taps than the index field can tell apart
+    const uint64_t fieldValues = sig.length >= 32 ? uint64_t{UINT32_MAX} + 1 : 1ull << sig.length;
+    const auto taps = static_cast<uint32_t>(
+        std::min<uint64_t>({pack->taps, fieldValues, uint64_t{MUX_GROUP_MAX}}));
+    layout = {.multiplexor = static_cast<int32_t>(i), .tapped = true};
+    for (uint32_t value = 0; value < taps; value++) layout.values.push_back(value);
+    return layout;
+  }
+  if (layout.multiplexor < 0 || layout.values.empty()) return {};
+
+  std::sort(layout.values.begin(), layout.values.end());
+  layout.values.erase(std::unique(layout.values.begin(), layout.values.end()),
+                      layout.values.end());
+  if (layout.values.size() > MUX_GROUP_MAX) layout.values.resize(MUX_GROUP_MAX);
+  return layout;
+}
+
+// BA_DEF_ BO_ "GenMsgSendType" ENUM "<label>","<label>",... ;
+// enum attributes are set by index, so the labels are kept to resolve them
+void DbcParser::parseAttributeDefinition(std::string_view line) {
+  std::string_view name{};
+  if (nextToken(line) != "BO_" || !nextQuoted(line, name) || name != "GenMsgSendType") return;
+  if (nextToken(line) != "ENUM") return;
+  sendTypeLabels.clear();
+  std::string_view label{};
+  while (nextQuoted(line, label)) {
+    sendTypeLabels.push_back(label);
+    if (!expect(line, ',')) break;
+  }
+}
+
+// either the label itself or its index into the BA_DEF_ enum
+SendType DbcParser::sendType(std::string_view& line) {
+  std::string_view label{};
+  if (nextQuoted(line, label)) return sendTypeNamed(label);
+  uint32_t index = 0;
+  if (!nextNumber(line, index)) return SendType::Unknown;
+  if (index < sendTypeLabels.size()) return sendTypeNamed(sendTypeLabels[index]);
+  return index < 6 ? static_cast<SendType>(index + 1) : SendType::Unknown;
+}
+
+// BA_DEF_DEF_ "<attribute>" <value>;
+void DbcParser::parseAttributeDefault(std::string_view line) {
+  std::string_view name{};
+  if (!nextQuoted(line, name)) return;
+  if (name == "GenMsgCycleTime") nextNumber(line, defaultCycleTime);
+  if (name == "GenMsgSendType") defaultSendType = sendType(line);
+}
+
+// BA_ "<attribute>" BO_ <id> <value>;
+void DbcParser::parseAttribute(std::string_view line) {
+  std::string_view name{};
+  uint32_t canId = 0;
+  if (!nextQuoted(line, name) || nextToken(line) != "BO_" || !nextNumber(line, canId)) return;
+  const auto it = messageIndex.find(canId);
+  if (it == messageIndex.end()) return;
+
+  DbcMessage& msg = model.messages[it->second];
+  cycleTimeSet.resize(model.messages.size());
+  sendTypeSet.resize(model.messages.size());
+  if (name == "GenMsgCycleTime" && nextNumber(line, msg.cycleTime)) {
+    cycleTimeSet[it->second] = true;
+  } else if (name == "GenMsgSendType") {
+    msg.sendType = sendType(line);
+    sendTypeSet[it->second] = true;
+  }
+}
+
+void DbcParser::applyAttributeDefaults() {
+  cycleTimeSet.resize(model.messages.size());
+  sendTypeSet.resize(model.messages.size());
+  for (size_t i = 0; i < model.messages.size(); i++) {
+    if (!cycleTimeSet[i]) model.messages[i].cycleTime = defaultCycleTime;
+    if (!sendTypeSet[i]) model.messages[i].sendType = defaultSendType;
+  }
+}
+
+// builds the model in one pass, signals of a message are stored contiguously
+// text only has to outlive the call, every name is copied into the model's pool
+bool parseDBC(std::string_view text, DbcModel& model) {
+  model = {};
+  DbcParser parser{.model = model};
+
+  while (!text.empty()) {
+    std::string_view line = skipSpace(nextLine(text));
+    const std::string_view tag = nextToken(line);
+    if (tag == "BO_") {
+      parser.parseMessage(line);
+    } else if (tag == "SG_" && parser.haveMsg) {
+      parser.parseSignal(line);
+    } else if (tag == "SIG_VALTYPE_") {
+      parser.parseValueType(line);
+    } else if (tag == "VAL_") {
+      parser.parseValues(line);
+    } else if (tag == "BA_DEF_") {
+      parser.parseAttributeDefinition(line);
+    } else if (tag == "BA_DEF_DEF_") {
+      parser.parseAttributeDefault(line);
+    } else if (tag == "BA_") {
+      parser.parseAttribute(line);
+    }
+  }
+  parser.applyAttributeDefaults();
+  return !model.messages.empty();
+}
@@ -0,0 +1,166 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "arena.hpp"
+#include "decode.hpp"
+
+// SG_ <name> M is the multiplexor, SG_ <name> m<value> is only present under that value
+enum class MuxRole : uint8_t { None = 0, Multiplexor, Multiplexed };
+
+// names are offsets into the owning string table
+struct DbcSignal {
+  uint32_t name{};
+  uint32_t unit{};
+  uint32_t receiver{};
+  int32_t startBit{};
+  int32_t length{};
+  int32_t endianness{};
+  datatype type = vINT;
+  bool isSigned{};
+  double scale = 1.0;
+  double offset = 0.0;
+  double min = 0.0;
+  double max = 0.0;
+  uint32_t firstValue{};
+  uint32_t valueCount{};
+  MuxRole mux = MuxRole::None;
+  uint32_t muxValue{};
+};
+
+// one VAL_ entry, a raw value and its label
+struct DbcValue {
+  int64_t raw{};
+  uint32_t label{};
+};
+
+// GenMsgSendType, in the order CANdb++ defines the enum
+enum class SendType : uint8_t {
+  Unknown = 0,
+  Cyclic,
+  Event,
+  CyclicAndEvent,
+  CyclicAndEventNoRepetition,
+  None,
+  Spontaneous,
+};
+
+// cycleTime is BA_ "GenMsgCycleTime" in ms, or its BA_DEF_DEF_, 0 when neither is given
+struct DbcMessage {
+  uint32_t id{};
+  uint32_t dlc{};
+  uint32_t name{};
+  uint32_t transmitter{};
+  uint32_t firstSignal{};
+  uint32_t signalCount{};
+  uint32_t cycleTime{};
+  SendType sendType = SendType::Unknown;
+};
+
+// frames per second the dbc promises for msg, 0 when it only sends on events or does not say
+constexpr double dbcMessageRate(const DbcMessage& msg) {
+  if (msg.cycleTime == 0) return 0.0;
+  if (msg.sendType == SendType::Event || msg.sendType == SendType::None ||
+      msg.sendType == SendType::Spontaneous)
+    return 0.0;
+  return 1000.0 / msg.cycleTime;
+}
+
+// read only view of a parsed dbc, either generated at build time or parsed at runtime
+struct DbcView {
+  std::span<const DbcMessage> messages{};
+  std::span<const DbcSignal> signals{};
+  std::span<const DbcValue> values{};
+  std::string_view strings{};
+  std::span<const MessageDecodeFn> decoders{};
+
+  const char* string(uint32_t offset) const { return strings.data() + offset; }
+};
+
+struct DbcModel {
+  std::vector<DbcMessage> messages{};
+  std::vector<DbcSignal> signals{};
+  std::vector<DbcValue> values{};
+  // interned, every distinct name is stored once
+  std::string strings{};
+
+  DbcView view() const { return {messages, signals, values, strings, {}}; }
+};
+
+bool parseDBC(std::string_view text, DbcModel& model);
+
+// array valued packs the dbc has no way to describe, a message carrying signal is read as
+// taps groups keyed by its values 0 to taps - 1, whatever its field could hold
+struct DbcTapPack {
+  std::string_view signal{};
+  uint32_t taps{};
+};
+
+constexpr DbcTapPack DBC_TAP_PACKS[] = {
+    // BPSCAN VoltTemp boards, 4 taps each
+    {"BPS_Tap_idx", 4},
+};
+
+// how the signals of one message split between the message and its mux groups, see Message
+// a tapped pack's signals other than its tap index all repeat per tap
+struct DbcMuxLayout {
+  int32_t multiplexor = -1;
+  bool tapped{};
+  std::vector<uint32_t> values{};
+
+  bool inMessage(const DbcSignal& sig, uint32_t i) const {
+    if (multiplexor < 0 || i == static_cast<uint32_t>(multiplexor)) return true;
+    return !tapped && sig.mux != MuxRole::Multiplexed;
+  }
+  bool inGroup(const DbcSignal& sig, uint32_t i, uint32_t value) const {
+    if (multiplexor < 0 || i == static_cast<uint32_t>(multiplexor)) return false;
+    return tapped || (sig.mux == MuxRole::Multiplexed && sig.muxValue == value);
+  }
+};
+
+DbcMuxLayout dbcMuxLayout(const DbcView& dbc, const DbcMessage& msg);
+
+constexpr DecodePlan makeDecodePlan(const DbcSignal& sig) {
+  return makeDecodePlan(sig.startBit, sig.length, sig.endianness, sig.isSigned, sig.type, sig.scale,
+                        sig.offset);
+}
+
+constexpr ColumnType columnType(const DbcSignal& sig) {
+  return columnType(sig.type, sig.length, sig.isSigned);
+}
+
+// one column with every constant folded in, see dbcgen
+template <const auto& Signals, uint32_t Index>
+void decodeStaticColumn(const uint64_t* words, const uint64_t* swapped, uint32_t count,
+                        double* out) {
+  constexpr DecodePlan plan = makeDecodePlan(Signals[Index]);
+  const uint64_t* src = plan.bswap ? swapped : words;
+  for (uint32_t i = 0; i < count; i++) {
+    const uint64_t raw = (src[i] >> plan.shift) & plan.mask;
+    if constexpr (plan.kind == DecodeKind::Signed)
+      out[i] = static_cast<double>(static_cast<int64_t>(raw << plan.signShift) >> plan.signShift) *
+                   plan.scale +
+               plan.offset;
+    else if constexpr (plan.kind == DecodeKind::Float)
+      out[i] = static_cast<double>(std::bit_cast<float>(static_cast<uint32_t>(raw))) * plan.scale +
+               plan.offset;
+    else if constexpr (plan.kind == DecodeKind::Double)
+      out[i] = std::bit_cast<double>(raw) * plan.scale + plan.offset;
+    else
+      out[i] = static_cast<double>(raw) * plan.scale + plan.offset;
+  }
+}
+
+template <const auto& Signals, uint32_t First, uint32_t Count>
+void decodeStatic(const uint64_t* words, const uint64_t* swapped, uint32_t count, double* columns,
+                  uint32_t stride) {
+  [&]<uint32_t... I>(std::integer_sequence<uint32_t, I...>) {
+    (decodeStaticColumn<Signals, First + I>(words, swapped, count,
+                                            columns + static_cast<size_t>(I) * stride),
+     ...);
+  }(std::make_integer_sequence<uint32_t, Count>{});
+}
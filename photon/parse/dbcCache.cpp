@@ -0,0 +1,183 @@
+#include "dbcCache.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <system_error>
+
+// fnv-1a over 8 byte words, stable across runs unlike std::hash
+// the length is mixed in last so a zero padded tail cannot collide
+uint64_t hashDBC(std::string_view text) {
+  constexpr uint64_t prime = 0x100000001B3ull;
+  uint64_t hash = 0xCBF29CE484222325ull;
+  size_t i = 0;
+  for (; i + 8 <= text.size(); i += 8) {
+    uint64_t word = 0;
+    std::memcpy(&word, text.data() + i, sizeof(word));
+    hash = (hash ^ word) * prime;
+  }
+  uint64_t tail = 0;
+  std::memcpy(&tail, text.data() + i, text.size() - i);
+  hash = (hash ^ tail) * prime;
+  return (hash ^ text.size()) * prime;
+}
+
+// same locations the updater uses, <cache>/Photon/dbc
+std::filesystem::path dbcCacheDir() {
+  std::filesystem::path dir{};
+#ifdef _WIN32
+  if (const char* local = std::getenv("LOCALAPPDATA"); local && *local)
+    dir = std::filesystem::path(local) / "Photon" / "cache" / "dbc";
+#else
+  if (const char* xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg)
+    dir = std::filesystem::path(xdg) / "Photon" / "dbc";
+  else if (const char* home = std::getenv("HOME"); home && *home)
+    dir = std::filesystem::path(home) / ".cache" / "Photon" / "dbc";
+#endif
+  return dir;
+}
+
+std::filesystem::path dbcCachePath(uint64_t hash) {
+  const std::filesystem::path dir = dbcCacheDir();
+  if (dir.empty()) return {};
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(hash));
+  return dir / name;
+}
+
+constexpr size_t alignCache(size_t offset) { return (offset + 7) & ~size_t{7}; }
+
+struct DbcCacheLayout {
+  size_t messages{};
+  size_t signals{};
+  size_t values{};
+  size_t strings{};
+  size_t size{};
+};
+
+DbcCacheLayout cacheLayout(const DbcCacheHeader& header) {
+  DbcCacheLayout layout{};
+  layout.messages = alignCache(sizeof(DbcCacheHeader));
+  layout.signals =
+      alignCache(layout.messages + static_cast<size_t>(header.messageCount) * sizeof(DbcMessage));
+  layout.values =
+      alignCache(layout.signals + static_cast<size_t>(header.signalCount) * sizeof(DbcSignal));
+  layout.strings =
+      alignCache(layout.values + static_cast<size_t>(header.valueCount) * sizeof(DbcValue));
+  layout.size = layout.strings + header.stringBytes;
+  return layout;
+}
+
+// a stale or truncated cache is treated as a miss, every offset is checked before use
+bool validCache(const DbcView& view) {
+  if (view.strings.empty() || view.strings.back() != '\0') return false;
+  const auto inStrings = [&](uint32_t offset) { return offset < view.strings.size(); };
+  for (const DbcMessage& msg : view.messages) {
+    if (!inStrings(msg.name) || !inStrings(msg.transmitter)) return false;
+    if (msg.firstSignal > view.signals.size() ||
+        msg.signalCount > view.signals.size() - msg.firstSignal)
+      return false;
+  }
+  for (const DbcSignal& sig : view.signals) {
+    if (!inStrings(sig.name) || !inStrings(sig.unit) || !inStrings(sig.receiver)) return false;
+    if (sig.firstValue > view.values.size() ||
+        sig.valueCount > view.values.size() - sig.firstValue)
+      return false;
+  }
+  for (const DbcValue& value : view.values)
+    if (!inStrings(value.label)) return false;
+  return true;
+}
+
+bool openDBCCache(const std::filesystem::path& path, uint64_t hash, MappedFile& file,
+                  DbcView& view) {
+  if (path.empty() || !file.open(path.string())) return false;
+
+  DbcCacheHeader header{};
+  if (file.size < sizeof(header)) {
+    file.close();
+    return false;
+  }
+  std::memcpy(&header, file.data, sizeof(header));
+  const DbcCacheLayout layout = cacheLayout(header);
+  if (header.magic != DBC_CACHE_MAGIC || header.version != DBC_CACHE_VERSION ||
+      header.hash != hash || header.messageSize != sizeof(DbcMessage) ||
+      header.signalSize != sizeof(DbcSignal) || header.valueSize != sizeof(DbcValue) ||
+      layout.size != file.size) {
+    file.close();
+    return false;
+  }
+
+  // the mapping is page aligned and every section is 8 byte aligned within it
+  view = {
+      .messages = {reinterpret_cast<const DbcMessage*>(file.data + layout.messages),
+                   header.messageCount},
+      .signals = {reinterpret_cast<const DbcSignal*>(file.data + layout.signals),
+                  header.signalCount},
+      .values = {reinterpret_cast<const DbcValue*>(file.data + layout.values), header.valueCount},
+      .strings = {file.data + layout.strings, header.stringBytes},
+      .decoders = {},
+  };
+  if (!validCache(view)) {
+    view = {};
+    file.close();
+    return false;
+  }
+  return true;
+}
+
+bool writeSection(std::FILE* out, const void* data, size_t bytes, size_t& offset, size_t at) {
+  static constexpr char padding[8]{};
+  if (at > offset && std::fwrite(padding, 1, at - offset, out) != at - offset) return false;
+  if (bytes && std::fwrite(data, 1, bytes, out) != bytes) return false;
+  offset = at + bytes;
+  return true;
+}
+
+// written to a temporary name and renamed, a reader never sees a partial file
+bool writeDBCCache(const std::filesystem::path& path, uint64_t hash, const DbcModel& model) {
+  if (path.empty()) return false;
+  std::error_code ec{};
+  std::filesystem::create_directories(path.parent_path(), ec);
+  if (ec) return false;
+
+  const DbcCacheHeader header{
+      .magic = DBC_CACHE_MAGIC,
+      .version = DBC_CACHE_VERSION,
+      .hash = hash,
+      .messageSize = sizeof(DbcMessage),
+      .signalSize = sizeof(DbcSignal),
+      .valueSize = sizeof(DbcValue),
+      .messageCount = static_cast<uint32_t>(model.messages.size()),
+      .signalCount = static_cast<uint32_t>(model.signals.size()),
+      .valueCount = static_cast<uint32_t>(model.values.size()),
+      .stringBytes = static_cast<uint32_t>(model.strings.size()),
+  };
+  const DbcCacheLayout layout = cacheLayout(header);
+
+  std::filesystem::path temp = path;
+  temp += ".tmp";
+  std::FILE* out = std::fopen(temp.string().c_str(), "wb");
+  if (!out) return false;
+  size_t offset = 0;
+  const bool written =
+      writeSection(out, &header, sizeof(header), offset, 0) &&
+      writeSection(out, model.messages.data(), model.messages.size() * sizeof(DbcMessage), offset,
+                   layout.messages) &&
+      writeSection(out, model.signals.data(), model.signals.size() * sizeof(DbcSignal), offset,
+                   layout.signals) &&
+      writeSection(out, model.values.data(), model.values.size() * sizeof(DbcValue), offset,
+                   layout.values) &&
+      writeSection(out, model.strings.data(), model.strings.size(), offset, layout.strings);
+  const bool closed = std::fclose(out) == 0;
+  if (!written || !closed) {
+    std::filesystem::remove(temp, ec);
+    return false;
+  }
+
+  std::filesystem::rename(temp, path, ec);
+  if (!ec) return true;
+  std::filesystem::remove(temp, ec);
+  return false;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+#include "dbc.hpp"
+#include "mapped.hpp"
+
+// parsed dbcs are cached as flat tables keyed by a hash of the dbc text
+// a hit is mapped and handed to the arena as a view, nothing is parsed or copied
+constexpr uint32_t DBC_CACHE_MAGIC = 0x43424450;  // "PDBC"
+constexpr uint32_t DBC_CACHE_VERSION = 3;
+
+struct DbcCacheHeader {
+  uint32_t magic{};
+  uint32_t version{};
+  uint64_t hash{};
+  uint32_t messageSize{};
+  uint32_t signalSize{};
+  uint32_t valueSize{};
+  uint32_t messageCount{};
+  uint32_t signalCount{};
+  uint32_t valueCount{};
+  uint32_t stringBytes{};
+  uint32_t reserved{};
+};
+
+uint64_t hashDBC(std::string_view text);
+std::filesystem::path dbcCachePath(uint64_t hash);
+bool openDBCCache(const std::filesystem::path& path, uint64_t hash, MappedFile& file,
+                  DbcView& view);
+bool writeDBCCache(const std::filesystem::path& path, uint64_t hash, const DbcModel& model);
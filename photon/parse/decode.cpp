@@ -0,0 +1,29 @@
+#include "decode.hpp"
+
+#include <cstdint>
+
+#include "arena.hpp"
+
+void buildMessagePlans(Message& msg) {
+  msg.minDlc = 0;
+  msg.decodable = msg.signalCount > 0;
+  for (uint32_t i = 0; i < msg.signalCount; i++) {
+    Signal* sig = msg.signals[i];
+    if (!sig) {
+      msg.decodable = false;
+      continue;
+    }
+    sig->plan = buildDecodePlan(*sig);
+    if (sig->plan.kind == DecodeKind::Invalid) msg.decodable = false;
+    if (sig->plan.minDlc > msg.minDlc) msg.minDlc = sig->plan.minDlc;
+  }
+}
+
+void buildDecodePlans(Arena& arena) {
+  for (const uint32_t id : arena.validIds) {
+    Message* found = arena.message(id);
+    if (!found) continue;
+    buildMessagePlans(*found);
+    for (uint32_t g = 0; g < found->muxCount; g++) buildMessagePlans(found->muxGroups[g]);
+  }
+}
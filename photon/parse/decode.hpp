@@ -0,0 +1,120 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#include "arena.hpp"
+
+// constexpr so build time generated decoders fold the plan into constants
+constexpr DecodePlan makeDecodePlan(int startBit, int length, int endianness, bool isSigned,
+                                    datatype type, double scale, double offset) {
+  DecodePlan plan{};
+  plan.scale = scale;
+  plan.offset = offset;
+  if (startBit < 0 || length <= 0 || length > 64) return plan;
+
+  int lsb = 0;
+  if (endianness == 1) {
+    // intel, dbc bit n is bit n of the little endian word
+    if (startBit + length > 64) return plan;
+    lsb = startBit;
+    plan.minDlc = static_cast<uint8_t>((startBit + length + 7) / 8);
+  } else {
+    // motorola, start bit is the msb in sawtooth numbering
+    // byte k of the payload lands in byte 7 - k of the swapped word
+    const int msb = (7 - startBit / 8) * 8 + startBit % 8;
+    lsb = msb - length + 1;
+    if (startBit >= 64 || lsb < 0) return plan;
+    plan.minDlc = static_cast<uint8_t>(8 - lsb / 8);
+    plan.bswap = true;
+  }
+
+  plan.shift = static_cast<uint8_t>(lsb);
+  plan.mask = length == 64 ? ~uint64_t{0} : (uint64_t{1} << length) - 1;
+  plan.signShift = static_cast<uint8_t>(64 - length);
+
+  switch (type) {
+    case vFLOAT:
+      if (length == 32) plan.kind = DecodeKind::Float;
+      break;
+    case vDOUBLE:
+      if (length == 64) plan.kind = DecodeKind::Double;
+      break;
+    case vINT:
+    default:
+      plan.kind = isSigned ? DecodeKind::Signed : DecodeKind::Unsigned;
+      break;
+  }
+  return plan;
+}
+
+// the narrowest column that holds every undecoded value of a signal exactly
+constexpr ColumnType columnType(datatype type, int length, bool isSigned) {
+  if (length <= 0 || length > 64) return ColumnType::Float64;
+  if (type == vFLOAT) return length == 32 ? ColumnType::Float32 : ColumnType::Float64;
+  if (type != vINT) return ColumnType::Float64;
+  if (length == 1 && !isSigned) return ColumnType::Bit;
+  if (length <= 8) return isSigned ? ColumnType::Int8 : ColumnType::UInt8;
+  if (length <= 16) return isSigned ? ColumnType::Int16 : ColumnType::UInt16;
+  if (length <= 32) return isSigned ? ColumnType::Int32 : ColumnType::UInt32;
+  return ColumnType::Float64;
+}
+
+inline DecodePlan buildDecodePlan(const Signal& sig) {
+  return makeDecodePlan(sig.startBit, sig.length, sig.endianness, sig.isSigned, sig.type, sig.scale,
+                        sig.offset);
+}
+
+void buildDecodePlans(Arena& arena);
+
+// loads the payload as a little endian word, intel signals index it directly
+inline uint64_t loadPayload(const uint8_t data[8]) {
+  uint64_t word = 0;
+  std::memcpy(&word, data, sizeof(word));
+  if constexpr (std::endian::native == std::endian::big) word = std::byteswap(word);
+  return word;
+}
+
+// the undecoded field, multiplexor values are matched against this rather than the scaled value
+inline uint64_t decodeRaw(const DecodePlan& plan, uint64_t word, uint64_t swapped) {
+  return ((plan.bswap ? swapped : word) >> plan.shift) & plan.mask;
+}
+
+// one shift and mask per signal, motorola signals read the byte swapped word
+inline bool decodeSignal(const DecodePlan& plan, uint64_t word, uint64_t swapped, uint8_t dlc,
+                         double& value) {
+  if (dlc < plan.minDlc) return false;
+  const uint64_t raw = ((plan.bswap ? swapped : word) >> plan.shift) & plan.mask;
+
+  switch (plan.kind) {
+    case DecodeKind::Unsigned:
+      value = static_cast<double>(raw) * plan.scale + plan.offset;
+      return true;
+    case DecodeKind::Signed: {
+      const int64_t extended = static_cast<int64_t>(raw << plan.signShift) >> plan.signShift;
+      value = static_cast<double>(extended) * plan.scale + plan.offset;
+      return true;
+    }
+    case DecodeKind::Float:
+      value = static_cast<double>(std::bit_cast<float>(static_cast<uint32_t>(raw))) * plan.scale +
+              plan.offset;
+      return true;
+    case DecodeKind::Double:
+      value = std::bit_cast<double>(raw) * plan.scale + plan.offset;
+      return true;
+    case DecodeKind::Invalid:
+    default:
+      return false;
+  }
+}
+
+// decodes every signal of a message, fails the frame if any signal does
+inline bool decodeMessage(const Message& msg, const uint8_t data[8], uint8_t dlc, double* values) {
+  const uint64_t word = loadPayload(data);
+  const uint64_t swapped = std::byteswap(word);
+  for (uint32_t i = 0; i < msg.signalCount; i++) {
+    const Signal* sig = msg.signals[i];
+    if (!sig || !decodeSignal(sig->plan, word, swapped, dlc, values[i])) return false;
+  }
+  return true;
+}
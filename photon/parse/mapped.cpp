@@ -0,0 +1,68 @@
+#include "mapped.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool MappedFile::open(const std::string& path) {
+  close();
+#ifdef _WIN32
+  HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (handle == INVALID_HANDLE_VALUE) return false;
+  LARGE_INTEGER fileSize{};
+  if (!GetFileSizeEx(handle, &fileSize) || fileSize.QuadPart == 0) {
+    CloseHandle(handle);
+    return false;
+  }
+  HANDLE view = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!view) {
+    CloseHandle(handle);
+    return false;
+  }
+  data = static_cast<const char*>(MapViewOfFile(view, FILE_MAP_READ, 0, 0, 0));
+  if (!data) {
+    CloseHandle(view);
+    CloseHandle(handle);
+    return false;
+  }
+  file = handle;
+  mapping = view;
+  size = static_cast<size_t>(fileSize.QuadPart);
+#else
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return false;
+  struct stat st{};
+  if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+    ::close(fd);
+    return false;
+  }
+  void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  // the mapping keeps the file referenced, the descriptor is not needed past this
+  ::close(fd);
+  if (p == MAP_FAILED) return false;
+  data = static_cast<const char*>(p);
+  size = static_cast<size_t>(st.st_size);
+#endif
+  return true;
+}
+
+void MappedFile::close() {
+  if (!data) return;
+#ifdef _WIN32
+  UnmapViewOfFile(data);
+  CloseHandle(mapping);
+  CloseHandle(file);
+  file = nullptr;
+  mapping = nullptr;
+#else
+  munmap(const_cast<char*>(data), size);
+#endif
+  data = nullptr;
+  size = 0;
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// read only view of a whole file, mapped instead of copied
+struct MappedFile {
+  const char* data{};
+  size_t size{};
+#ifdef _WIN32
+  void* file{};
+  void* mapping{};
+#endif
+
+  bool open(const std::string& path);
+  void close();
+  std::string_view view() const { return {data, size}; }
+};
@@ -1,236 +1,593 @@
 #include "parse.hpp"
 
-#include <fstream>
-#include <istream>
-#include <sstream>
+#include <algorithm>
+#include <bit>
+#include <chrono>
 #include <string>
+#include <unordered_set>
 
 #include "../engine/include.hpp"
 #include "arena.hpp"
-#include "assettoCorsa_dbc.hpp"
-#include "daybreak_master_dbc.hpp"
-#include "lonestar_dbc.hpp"
-#include "test_dbc.hpp"
+#include "BPSCAN_dbc_table.hpp"
+#include "CarCAN_dbc_table.hpp"
+#include "MotorCAN_dbc_table.hpp"
+#include "assettoCorsa_dbc_table.hpp"
+#include "daybreak_master_dbc_table.hpp"
+#include "dbc.hpp"
+#include "dbcCache.hpp"
+#include "decode.hpp"
+#include "lonestar_dbc_table.hpp"
+#include "mapped.hpp"
+#include "prohelion_wavesculptor22_dbc_table.hpp"
+#include "test_dbc_table.hpp"
 
-struct DBCAsset {
+// the car's buses, in the order their dbcs are bound
+constexpr std::array<BusView, 1> lonestarViews{{{0, lonestar_dbc_table::view}}};
+constexpr std::array<BusView, 1> daybreakMasterViews{{{0, daybreak_master_dbc_table::view}}};
+constexpr std::array<BusView, 1> testViews{{{0, test_dbc_table::view}}};
+constexpr std::array<BusView, 1> assettoCorsaViews{{{0, assettoCorsa_dbc_table::view}}};
+constexpr std::array<BusView, 4> carViews{{
+    {0, CarCAN_dbc_table::view},
+    {1, MotorCAN_dbc_table::view},
+    {2, BPSCAN_dbc_table::view},
+    {3, prohelion_wavesculptor22_dbc_table::view},
+}};
+
+struct DBCBuiltin {
   DBCType kind;
   const char* name;
-  const unsigned char* data;
-  std::size_t size;
+  std::span<const BusView> views;
 };
 
-DBCAsset dbcAsset(DBCType kind) {
+DBCBuiltin dbcBuiltin(DBCType kind) {
   switch (kind) {
     case DBCType::Lonestar:
-      return {DBCType::Lonestar, "Lonestar", lonestar_dbc, lonestar_dbc_size};
+      return {DBCType::Lonestar, "Lonestar", lonestarViews};
     case DBCType::DaybreakMaster:
-      return {DBCType::DaybreakMaster, "daybreak-master", daybreak_master_dbc,
-              daybreak_master_dbc_size};
+      return {DBCType::DaybreakMaster, "daybreak-master", daybreakMasterViews};
     case DBCType::Test:
-      return {DBCType::Test, "test", test_dbc, test_dbc_size};
+      return {DBCType::Test, "test", testViews};
     case DBCType::AssettoCorsa:
-      return {DBCType::AssettoCorsa, "assettoCorsa", assettoCorsa_dbc, assettoCorsa_dbc_size};
+      return {DBCType::AssettoCorsa, "assettoCorsa", assettoCorsaViews};
+    case DBCType::Car:
+      return {DBCType::Car, "car (4 buses)", carViews};
     case DBCType::File:
-      return {DBCType::File, "selected-file", nullptr, 0};
+      return {DBCType::File, "selected-file", {}};
   }
-  return {DBCType::File, "unknown", nullptr, 0};
+  return {DBCType::File, "unknown", {}};
 }
 
-void buildConfig(std::istream& stream, arenaConfig& config) {
+// keys are (bus, id), so the same id on two buses is two messages
+// within one bus the first definition wins, ids that are not can ids are skipped loudly
+// rates come from GenMsgCycleTime, messages without one fall back to ARENA_DEFAULT_RATE
+// column types follow each signal's dbc width, only a typed arena uses them
+// storage options already set on config are kept
+void buildConfig(std::span<const BusView> views, arenaConfig& config) {
   std::vector<uint32_t> validIds{};
-  std::array<uint32_t, MESSAGE_MAX> signalCounts{};
-  std::string line;
-  uint32_t currentId = 0;
-  bool haveMsg = false;
-
-  while (std::getline(stream, line)) {
-    line.erase(0, line.find_first_not_of(" \t\r\n"));
-    if (line.empty()) continue;
-    if (line.rfind("BO_", 0) == 0) {
-      haveMsg = false;
-      uint32_t canId = 0;
-      uint32_t dlc = 0;
-      std::string sender{};
-      std::string tag{};
-      std::string tmp{};
-      std::string dlcStr{};
-      std::istringstream iss(line);
-      iss >> tag >> canId >> tmp >> dlcStr >> sender;
-      if (canId >= MESSAGE_MAX) continue;
-      if (tmp.find(':') == std::string::npos) continue;
-      try {
-        dlc = static_cast<uint8_t>(std::stoi(dlcStr));
-      } catch (...) {
+  std::vector<uint32_t> signalCounts{};
+  std::vector<MuxConfig> mux{};
+  std::vector<double> rates{};
+  std::vector<std::vector<ColumnType>> columns{};
+  std::unordered_set<uint32_t> seen{};
+  for (const BusView& bus : views) {
+    const DbcView& dbc = bus.view;
+    if (bus.bus >= CAN_BUS_MAX) {
+      logs("skipping bus " << bus.bus << ", only " << CAN_BUS_MAX << " buses are keyed");
+      continue;
+    }
+    for (const DbcMessage& msg : dbc.messages) {
+      if (!validMessageId(msg.id)) {
+        logs("skipping " << dbc.string(msg.name) << ", " << msg.id << " is not a can id");
         continue;
       }
-      (void)dlc;
-      haveMsg = true;
-      currentId = canId;
-      validIds.push_back(canId);
-    } else if (line.rfind("SG_ ", 0) == 0 && haveMsg) {
-      signalCounts[currentId]++;
-    }
-  }
-
-  config = {
-      .arenaSize = MINIMUM_ARENA_SIZE,
-      .signalCounts = signalCounts,
-      .validIds = validIds,
-  };
-}
-
-void populateArena(Arena& arena, std::istream& stream) {
-  std::string line;
-  uint32_t currentId = 0;
-  uint32_t currentIndex = 0;
-  bool haveCurrentMessage = false;
-
-  while (std::getline(stream, line)) {
-    line.erase(0, line.find_first_not_of(" \t\r\n"));
-    if (line.empty()) continue;
-    if (line.rfind("BO_", 0) == 0) {
-      haveCurrentMessage = false;
-      uint32_t canId = 0;
-      uint32_t dlc = 0;
-      std::string sender{};
-      std::string tag{};
-      std::string tmp{};
-      std::string dlcStr{};
-      std::istringstream iss(line);
-      iss >> tag >> canId >> tmp >> dlcStr >> sender;
-      if (canId >= MESSAGE_MAX || !arena.messages[canId]) continue;
-      const auto colon = tmp.find(':');
-      if (colon == std::string::npos) continue;
-      try {
-        dlc = static_cast<uint8_t>(std::stoi(dlcStr));
-      } catch (...) {
+      const uint32_t key = messageKey(bus.bus, msg.id);
+      if (!seen.insert(key).second) continue;
+      if (validIds.size() == MESSAGE_MAX) {
+        logs("skipping " << dbc.string(msg.name) << ", more than " << MESSAGE_MAX << " messages");
         continue;
       }
 
-      currentId = canId;
-      haveCurrentMessage = true;
-      currentIndex = 0;
-      Message* msg = arena.messages[canId];
-      msg->id = canId;
-      msg->dlc = dlc;
-      msg->name = tmp.substr(0, colon);
-      msg->transmitter = sender;
-    } else if (line.rfind("SG_ ", 0) == 0 && haveCurrentMessage) {
-      Message* msg = arena.messages[currentId];
-      if (!msg || currentIndex >= msg->signalCount) continue;
-      Signal* sig = msg->signals[currentIndex++];
-      std::istringstream iss(line);
-      std::string tag{};
-      std::string sigName{};
-      char c = '\0';
-      iss >> tag >> sigName;
-      sig->name = sigName;
-      while (iss >> c && c != ':') {
+      // counts follow the same membership populateArena fills signals by
+      const DbcMuxLayout layout = dbcMuxLayout(dbc, msg);
+      MuxConfig next{.tapped = layout.tapped, .values = layout.values};
+      uint32_t count = 0;
+      std::vector<ColumnType> messageColumns{};
+      for (uint32_t i = 0; i < msg.signalCount; i++) {
+        const DbcSignal& sig = dbc.signals[msg.firstSignal + i];
+        if (i == static_cast<uint32_t>(layout.multiplexor)) next.multiplexor = count;
+        if (!layout.inMessage(sig, i)) continue;
+        count++;
+        messageColumns.push_back(columnType(sig));
       }
-      if (c != ':') continue;
-      iss >> sig->startBit;
-      iss.ignore(1, '|');
-      iss >> sig->length;
-      iss.ignore(1, '@');
-      iss >> sig->endianness >> c;
-      sig->isSigned = (c == '-');
-      if (iss >> c && c == '(') {
-        iss >> sig->scale;
-        iss.ignore(1, ',');
-        iss >> sig->offset;
-        iss.ignore(1, ')');
+      for (const uint32_t value : layout.values) {
+        uint32_t groupCount = 0;
+        std::vector<ColumnType> groupColumns{};
+        for (uint32_t i = 0; i < msg.signalCount; i++) {
+          const DbcSignal& sig = dbc.signals[msg.firstSignal + i];
+          if (!layout.inGroup(sig, i, value)) continue;
+          groupCount++;
+          groupColumns.push_back(columnType(sig));
+        }
+        next.signalCounts.push_back(groupCount);
+        next.columns.push_back(std::move(groupColumns));
       }
-      if (iss >> c && c == '[') {
-        iss >> sig->min;
-        iss.ignore(1, '|');
-        iss >> sig->max;
-        iss.ignore(1, ']');
+      validIds.push_back(key);
+      signalCounts.push_back(count);
+      columns.push_back(std::move(messageColumns));
+      mux.push_back(std::move(next));
+      rates.push_back(dbcMessageRate(msg));
+    }
+  }
+
+  config.arenaSize = MINIMUM_ARENA_SIZE;
+  config.signalCounts = std::move(signalCounts);
+  config.validIds = std::move(validIds);
+  config.mux = std::move(mux);
+  config.rates = std::move(rates);
+  config.columns = std::move(columns);
+}
+
+void fillSignal(Signal& sig, const DbcSignal& desc, const char* strings) {
+  sig.name = strings + desc.name;
+  sig.unit = strings + desc.unit;
+  sig.receiver = strings + desc.receiver;
+  sig.startBit = desc.startBit;
+  sig.length = desc.length;
+  sig.endianness = desc.endianness;
+  sig.type = desc.type;
+  sig.isSigned = desc.isSigned;
+  sig.scale = desc.scale;
+  sig.offset = desc.offset;
+  sig.min = desc.min;
+  sig.max = desc.max;
+}
+
+void populateArena(Arena& arena, std::span<const BusView> views) {
+  // one pool for every bus, names below point into it rather than owning strings
+  std::vector<size_t> bases{};
+  for (const BusView& bus : views) {
+    bases.push_back(arena.strings.size());
+    arena.strings.append(bus.view.strings);
+  }
+  for (size_t v = 0; v < views.size(); v++) {
+    const DbcView& dbc = views[v].view;
+    if (views[v].bus >= CAN_BUS_MAX) continue;
+    const char* strings = arena.strings.c_str() + bases[v];
+    for (size_t m = 0; m < dbc.messages.size(); m++) {
+      const DbcMessage& desc = dbc.messages[m];
+      if (!validMessageId(desc.id)) continue;
+      Message* msg = arena.message(messageKey(views[v].bus, desc.id));
+      if (!msg || *msg->name) continue;
+      msg->dlc = desc.dlc;
+      msg->name = strings + desc.name;
+      msg->transmitter = strings + desc.transmitter;
+      // generated decoders cover the first SIGNAL_MAX signals of their message
+      if (m < dbc.decoders.size() && !msg->muxCount) msg->decode = dbc.decoders[m];
+
+      const DbcMuxLayout layout = dbcMuxLayout(dbc, desc);
+      uint32_t next = 0;
+      for (uint32_t i = 0; i < desc.signalCount && next < msg->signalCount; i++) {
+        const DbcSignal& sig = dbc.signals[desc.firstSignal + i];
+        if (layout.inMessage(sig, i)) fillSignal(*msg->signals[next++], sig, strings);
       }
-      if (iss >> std::ws && iss.peek() == '"') {
-        iss.get();
-        std::getline(iss, sig->unit, '"');
+      for (uint32_t g = 0; g < msg->muxCount; g++) {
+        Message& group = msg->muxGroups[g];
+        group.dlc = msg->dlc;
+        group.name = msg->name;
+        group.transmitter = msg->transmitter;
+        next = 0;
+        for (uint32_t i = 0; i < desc.signalCount && next < group.signalCount; i++) {
+          const DbcSignal& sig = dbc.signals[desc.firstSignal + i];
+          if (layout.inGroup(sig, i, group.muxValue))
+            fillSignal(*group.signals[next++], sig, strings);
+        }
       }
-      if (iss >> std::ws) iss >> sig->receiver;
-    } else if (line.rfind("SIG_VALTYPE_", 0) == 0) {
-      std::istringstream iss(line);
-      std::string tag{};
-      std::string sigName{};
-      std::string colon{};
-      std::string typeStr{};
-      uint32_t canId = 0;
-      uint32_t rawType = 0;
-      iss >> tag >> canId >> sigName >> colon >> typeStr;
-      if (canId >= MESSAGE_MAX || !arena.messages[canId] || typeStr.empty()) continue;
-      if (typeStr.back() == ';') typeStr.pop_back();
-      try {
-        rawType = static_cast<uint32_t>(std::stoi(typeStr));
-      } catch (...) {
-        continue;
+    }
+  }
+  buildDecodePlans(arena);
+}
+
+// every field that shapes how frames are stored or decoded, bus by bus, a word each so the
+// padding inside DbcMessage and DbcSignal never reaches the hash, names by their text
+uint64_t hashViews(std::span<const BusView> views) {
+  constexpr uint64_t prime = 0x100000001B3ull;
+  uint64_t hash = 0xCBF29CE484222325ull;
+  auto mix = [&](uint64_t word) { hash = (hash ^ word) * prime; };
+  auto mixInt = [&](int32_t value) { mix(static_cast<uint32_t>(value)); };
+  auto mixDouble = [&](double value) { mix(std::bit_cast<uint64_t>(value)); };
+  for (const BusView& bus : views) {
+    mix(bus.bus);
+    mix(bus.view.messages.size());
+    for (const DbcMessage& msg : bus.view.messages) {
+      mix(msg.id);
+      mix(msg.dlc);
+      mix(msg.name);
+      mix(msg.firstSignal);
+      mix(msg.signalCount);
+      mix(msg.cycleTime);
+      mix(static_cast<uint64_t>(msg.sendType));
+    }
+    mix(bus.view.signals.size());
+    for (const DbcSignal& sig : bus.view.signals) {
+      mix(sig.name);
+      mix(sig.unit);
+      mixInt(sig.startBit);
+      mixInt(sig.length);
+      mixInt(sig.endianness);
+      mix(static_cast<uint64_t>(sig.type));
+      mix(sig.isSigned);
+      mixDouble(sig.scale);
+      mixDouble(sig.offset);
+      mix(static_cast<uint64_t>(sig.mux));
+      mix(sig.muxValue);
+    }
+    mix(hashDBC(bus.view.strings));
+  }
+  return hash;
+}
+
+bool Parse::loadView(const DbcView& dbc) {
+  const BusView bus{0, dbc};
+  return loadViews({&bus, 1});
+}
+
+// every bus shares one arena, a single ingest thread decodes all of them
+// source is what a session records to load the same dbcs again on reopen
+bool Parse::loadViews(std::span<const BusView> views, const SessionSource& source) {
+  arenaConfig config{
+      .retention = retention, .ring = true, .blocked = blocked, .raw = raw, .typed = typed};
+  buildConfig(views, config);
+  if (config.validIds.empty()) return false;
+  if (persist)
+    config.session =
+        newSessionPath(sessionPath.empty() ? sessionDir() : std::filesystem::path(sessionPath))
+            .string();
+  return loadArena(views, config, source);
+}
+
+// a session arena is created or reopened as config asks, one that cannot be created is still
+// loaded without a file, one that cannot be reopened is not loaded at all
+bool Parse::loadArena(std::span<const BusView> views, const arenaConfig& config,
+                      const SessionSource& source) {
+  std::lock_guard lock(loadMutex);
+  auto* next = new Arena{};
+  next->init(config);
+  if (!next->pool) {
+    delete next;
+    return false;
+  }
+  populateArena(*next, views);
+  if (config.reopen && !restoreSession(*next)) {
+    logs("session " << config.session << " does not match its dbcs");
+    next->destroy();
+    delete next;
+    return false;
+  }
+  if (!config.session.empty() && !config.reopen && !createSession(*next, hashViews(views), source))
+    logs("session " << config.session << " could not be created, recording nothing");
+  // arenas are separate objects now, the epoch tells a swapped in one apart from the last
+  next->generation = epoch.load();
+  cold.clear(next->generation);
+  publish(next);
+  lastResize = std::chrono::steady_clock::now();
+  return true;
+}
+
+// rebuilds the published arena around measured rates and a new retention target,
+// the newest samples of every buffer carry over, appends racing the copy are caught up
+// by publish, so it must not be called from an appending reader
+bool Parse::resize(double retentionSeconds) {
+  std::lock_guard lock(loadMutex);
+  // only loads publish and they hold loadMutex, so the published arena cannot retire here
+  const Arena* current = published.load();
+  if (!current || !current->pool) return false;
+
+  arenaConfig config = current->layout();
+  config.retention = std::max(retentionSeconds, 0.0);
+  // a session moves to a new file, the old one stays behind as it was
+  if (current->sessionHeader)
+    config.session =
+        newSessionPath(std::filesystem::path(current->session).parent_path()).string();
+  auto* next = new Arena{};
+  next->init(config);
+  if (!next->pool) {
+    delete next;
+    return false;
+  }
+  next->copyFrom(*current);
+  if (current->sessionHeader &&
+      !createSession(*next, current->sessionHeader->dbcHash, current->sessionHeader->source))
+    logs("session " << config.session << " could not be created, recording nothing");
+  next->generation = epoch.load();
+  retention = config.retention;
+  logs("arena resized to " << next->arenaSize << " bytes for " << retention << " s");
+  next->catchingUp.store(true, std::memory_order_release);
+  publish(next);
+  lastResize = std::chrono::steady_clock::now();
+  return true;
+}
+
+// called every compactor pass, rates are only compared once the interval has passed
+bool Parse::resizeIfDrifted() {
+  if (!autoResize) return false;
+  bool drifted = false;
+  {
+    std::lock_guard lock(loadMutex);
+    const auto now = std::chrono::steady_clock::now();
+    if (now - lastResize < ARENA_RESIZE_INTERVAL) return false;
+    lastResize = now;
+    const Arena* current = published.load();
+    if (!current || current->sessionHeader) return false;
+    for (const uint32_t id : current->validIds) {
+      const Message* msg = current->message(id);
+      if (!msg || msg->rate <= 0.0) continue;
+      const double measured = current->measuredRate(*msg);
+      if (measured <= 0.0) continue;
+      if (measured > msg->rate * ARENA_RESIZE_DRIFT || measured * ARENA_RESIZE_DRIFT < msg->rate) {
+        drifted = true;
+        break;
       }
+    }
+  }
+  return drifted && resize(retention);
+}
 
-      datatype type = vINT;
-      if (rawType == 1) type = vFLOAT;
-      if (rawType == 2) type = vDOUBLE;
-      Message* msg = arena.messages[canId];
-      for (size_t i = 0; i < msg->signalCount; ++i)
-        if (msg->signals[i] && msg->signals[i]->name == sigName) {
-          msg->signals[i]->type = type;
-          break;
-        }
+// readers that entered before the swap may still hold the old arena,
+// it is retired at the new epoch and freed by a later reclaim
+// an arena still catching up first takes over what old was given after the copy, once every
+// appending reader that entered before the swap has left, they skip it until then
+// only appenders are waited for, a reader pinned while it waits on loadMutex would deadlock
+void Parse::publish(Arena* next) {
+  Arena* old = published.exchange(next);
+  const uint64_t retiredAt = epoch.fetch_add(1) + 1;
+  if (next && next->catchingUp.load(std::memory_order_acquire)) {
+    for (const ArenaReaderSlot& reader : readers) {
+      if (!reader.appends.load()) continue;
+      for (uint64_t seen = reader.epoch.load(); seen != ARENA_EPOCH_IDLE && seen < retiredAt;
+           seen = reader.epoch.load())
+        std::this_thread::yield();
     }
+    if (old) next->catchUp(*old);
+    next->catchingUp.store(false, std::memory_order_release);
+  }
+  if (old) {
+    std::lock_guard lock(retireMutex);
+    retired.push_back({old, retiredAt});
   }
+  reclaim();
 }
 
-void Parse::init() { loadDBC(activeDBC); }
+void Parse::reclaim() {
+  uint64_t oldest = UINT64_MAX;
+  for (const ArenaReaderSlot& reader : readers) {
+    const uint64_t seen = reader.epoch.load();
+    if (seen != ARENA_EPOCH_IDLE && seen < oldest) oldest = seen;
+  }
 
-bool Parse::loadDBC(DBCType kind) {
-  const DBCAsset asset = dbcAsset(kind);
-  if (!asset.data || asset.size == 0) return false;
+  std::vector<Arena*> freed{};
+  {
+    std::lock_guard lock(retireMutex);
+    std::erase_if(retired, [&](const RetiredArena& r) {
+      if (r.epoch > oldest) return false;
+      freed.push_back(r.arena);
+      return true;
+    });
+  }
+  for (Arena* arena : freed) {
+    arena->destroy();
+    delete arena;
+  }
+}
 
-  std::string dbcText(reinterpret_cast<const char*>(asset.data), asset.size);
-  std::istringstream configStream(dbcText);
-  arenaConfig config{};
-  buildConfig(configStream, config);
-  if (config.validIds.empty()) return false;
+bool ArenaReader::attach(Parse& owner, bool appending) {
+  detach();
+  for (uint32_t i = 0; i < ARENA_READERS_MAX; i++) {
+    bool expected = false;
+    if (owner.readers[i].claimed.compare_exchange_strong(expected, true)) {
+      owner.readers[i].appends.store(appending);
+      parse = &owner;
+      slot = i;
+      appends = appending;
+      return true;
+    }
+  }
+  return false;
+}
 
-  arena.destroy();
-  arena.init(config);
-  std::istringstream populateStream(dbcText);
-  populateArena(arena, populateStream);
+void ArenaReader::detach() {
+  if (!parse) return;
+  unlock();
+  parse->readers[slot].appends.store(false);
+  parse->readers[slot].claimed.store(false);
+  parse = nullptr;
+  slot = ARENA_READERS_MAX;
+}
+
+// the epoch is published before the arena is loaded, so any swap this read
+// races with retires the old arena at an epoch after the one recorded here
+Arena* ArenaReader::lock() {
+  if (!parse) return nullptr;
+  ArenaReaderSlot& reader = parse->readers[slot];
+  for (;;) {
+    reader.epoch.store(parse->epoch.load());
+    Arena* arena = parse->published.load();
+    if (!arena) return &parse->emptyArena;
+    if (!appends || !arena->catchingUp.load(std::memory_order_acquire)) return arena;
+    reader.epoch.store(ARENA_EPOCH_IDLE);
+    std::this_thread::yield();
+  }
+}
+
+void ArenaReader::unlock() {
+  if (parse) parse->readers[slot].epoch.store(ARENA_EPOCH_IDLE);
+}
+
+void Parse::init() {
+  loadDBC(activeDBC);
+  compactor = std::jthread([this](std::stop_token stoken) { compactLoop(stoken); });
+}
+
+// resizes the arena once its rates drift, folds raw and typed pyramids, seals whatever filled
+// up since the last pass, from whichever arena is published by then, and checkpoints it when
+// it records a session
+void Parse::compactLoop(std::stop_token stoken) {
+  ArenaReader reader{};
+  if (!reader.attach(*this)) return;
+  auto checkpointed = std::chrono::steady_clock::now();
+  while (!stoken.stop_requested()) {
+    resizeIfDrifted();
+    Arena* arena = reader.lock();
+    // pyramids fold whether or not history is compressed, the hot window alone cannot hold it
+    arena->foldPending();
+    if (compact.load(std::memory_order_relaxed)) cold.compact(*arena);
+    // the disk is waited on unpinned, a swap meanwhile drops the checkpoint
+    SessionCheckpoint checkpoint{};
+    const bool due = std::chrono::steady_clock::now() - checkpointed >= SESSION_CHECKPOINT_INTERVAL;
+    const bool checkpointing = due && beginCheckpoint(*arena, checkpoint);
+    reader.unlock();
+    if (checkpointing) {
+      flushCheckpoint(checkpoint);
+      endCheckpoint(*reader.lock(), checkpoint, false);
+      reader.unlock();
+      checkpointed = std::chrono::steady_clock::now();
+    }
+    std::this_thread::sleep_for(COLD_COMPACT_INTERVAL);
+  }
+  reader.detach();
+}
+
+// built in dbcs are compiled into tables at build time, see dbcgen
+bool Parse::loadDBC(DBCType kind) {
+  const DBCBuiltin builtin = dbcBuiltin(kind);
+  const SessionSource source{.kind = static_cast<uint32_t>(kind)};
+  if (builtin.views.empty() || !loadViews(builtin.views, source)) return false;
   activeDBC = kind;
-  activeDBCLabel = asset.name;
+  activeDBCLabel = builtin.name;
   activeDBCPath.clear();
   return true;
 }
 
 bool Parse::loadDBCFile(const std::string& path) {
-  std::ifstream stream(path, std::ios::binary);
-  if (!stream) return false;
+  const BusFile file{0, path};
+  return loadDBCFiles({&file, 1});
+}
 
-  std::string dbcText((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
-  if (dbcText.empty()) return false;
+// a dbc file opened for one load, either a mapped cache hit or a fresh parse
+struct OpenedDBC {
+  MappedFile cache{};
+  DbcModel model{};
+  DbcView view{};
+  bool cached{};
+};
 
-  std::istringstream configStream(dbcText);
-  arenaConfig config{};
-  buildConfig(configStream, config);
-  if (config.validIds.empty()) return false;
+// the file is mapped and hashed, a cached parse of the same text is used as is
+// otherwise it is tokenized in place and the result cached for the next load
+bool openDBC(const std::string& path, OpenedDBC& opened) {
+  MappedFile file{};
+  if (!file.open(path)) return false;
 
-  arena.destroy();
-  arena.init(config);
-  std::istringstream populateStream(dbcText);
-  populateArena(arena, populateStream);
-  activeDBC = DBCType::File;
-  activeDBCPath = path;
+  const uint64_t hash = hashDBC(file.view());
+  const std::filesystem::path cachePath = dbcCachePath(hash);
+  if (openDBCCache(cachePath, hash, opened.cache, opened.view)) {
+    opened.cached = true;
+    return true;
+  }
+  if (!parseDBC(file.view(), opened.model)) return false;
+  opened.view = opened.model.view();
+  if (!writeDBCCache(cachePath, hash, opened.model))
+    logs("could not write dbc cache " << cachePath.string());
+  return true;
+}
+
+std::string fileLabel(const std::string& path) {
   const size_t slash = path.find_last_of("/\\");
-  activeDBCLabel = slash == std::string::npos ? path : path.substr(slash + 1);
+  return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+bool Parse::loadDBCFiles(std::span<const BusFile> files) {
+  if (files.empty()) return false;
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<OpenedDBC> opened(files.size());
+  std::vector<BusView> views{};
+  SessionSource source{.kind = static_cast<uint32_t>(DBCType::File)};
+  uint32_t cachedCount = 0;
+  for (size_t i = 0; i < files.size(); i++) {
+    if (!openDBC(files[i].path, opened[i])) return false;
+    views.push_back({files[i].bus, opened[i].view});
+    cachedCount += opened[i].cached;
+    if (i >= CAN_BUS_MAX) continue;
+    SessionFile& file = source.files[source.fileCount++];
+    file.bus = files[i].bus;
+    std::snprintf(file.path, sizeof(file.path), "%s", files[i].path.c_str());
+  }
+  if (!loadViews(views, source)) return false;
+  const auto loadUs = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+  logs("loaded " << files.size() << " dbc files (" << cachedCount << " from cache) in "
+                 << loadUs.count() << " us");
+
+  activeDBC = DBCType::File;
+  activeDBCPath = files.front().path;
+  activeDBCLabel.clear();
+  for (const BusFile& file : files) {
+    if (!activeDBCLabel.empty()) activeDBCLabel += " + ";
+    activeDBCLabel += fileLabel(file.path);
+  }
   return true;
 }
 
-void Parse::destroy() { arena.destroy(); }
+// maps a session file back in as the published arena, nothing is copied or ingested again
+// the dbcs it was recorded with are loaded the same way and have to hash the same
+bool Parse::openSession(const std::string& path) {
+  SessionHeader header{};
+  arenaConfig config{};
+  if (!readSession(path, header, config)) {
+    logs("not a session file " << path);
+    return false;
+  }
+  const auto kind = static_cast<DBCType>(header.source.kind);
+  std::vector<OpenedDBC> opened(header.source.fileCount);
+  std::vector<BusView> views{};
+  if (kind == DBCType::File) {
+    for (uint32_t i = 0; i < header.source.fileCount; i++) {
+      const SessionFile& file = header.source.files[i];
+      if (!openDBC(file.path, opened[i])) {
+        logs("session " << path << " needs " << file.path);
+        return false;
+      }
+      views.push_back({file.bus, opened[i].view});
+    }
+  } else {
+    const DBCBuiltin builtin = dbcBuiltin(kind);
+    views.assign(builtin.views.begin(), builtin.views.end());
+  }
+  if (views.empty() || hashViews(views) != header.dbcHash) {
+    logs("session " << path << " was recorded with a different dbc");
+    return false;
+  }
+  if (!loadArena(views, config, header.source)) return false;
+
+  activeDBC = kind;
+  activeDBCPath = kind == DBCType::File ? header.source.files[0].path : "";
+  activeDBCLabel = fileLabel(path);
+  return true;
+}
 
-const char* Parse::dbcName(DBCType kind) {
-  const DBCAsset asset = dbcAsset(kind);
-  return asset.name;
+// every reader has stopped by now, the compactor included, so everything retired can go at once
+void Parse::destroy() {
+  if (compactor.joinable()) {
+    compactor.request_stop();
+    compactor.join();
+  }
+  publish(nullptr);
+  std::lock_guard lock(retireMutex);
+  for (const RetiredArena& r : retired) {
+    r.arena->destroy();
+    delete r.arena;
+  }
+  retired.clear();
 }
 
+const char* Parse::dbcName(DBCType kind) { return dbcBuiltin(kind).name; }
+
 const char* Parse::currentDBCName() const { return activeDBCLabel.c_str(); }
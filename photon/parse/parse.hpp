@@ -1,27 +1,129 @@
 #pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <span>
+#include <stop_token>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "arena.hpp"
+#include "cold.hpp"
+#include "dbc.hpp"
+#include "session.hpp"
 
 enum class DBCType : uint32_t {
   Lonestar = 0,
   DaybreakMaster,
   Test,
   AssettoCorsa,
+  Car,
   File,
 };
 
+// one dbc bound to the bus its messages arrive on
+struct BusView {
+  uint32_t bus{};
+  DbcView view{};
+};
+
+struct BusFile {
+  uint32_t bus{};
+  std::string path{};
+};
+
+constexpr uint32_t ARENA_READERS_MAX = 16;
+// seconds of history every buffer is sized to hold at its message's rate
+constexpr double ARENA_DEFAULT_RETENTION = 600.0;
+// a measured rate this many times off the expected one resizes the arena,
+// at most once per ARENA_RESIZE_INTERVAL
+constexpr double ARENA_RESIZE_DRIFT = 4.0;
+constexpr std::chrono::seconds ARENA_RESIZE_INTERVAL{60};
+// how often the compactor looks for newly sealed blocks
+constexpr std::chrono::milliseconds COLD_COMPACT_INTERVAL{250};
+constexpr uint64_t ARENA_EPOCH_IDLE = 0;
+
+// epoch seen by one reading thread on entry, idle outside of a read
+struct alignas(64) ArenaReaderSlot {
+  std::atomic<bool> claimed{};
+  // the thread appends to what it locks, see Parse::publish
+  std::atomic<bool> appends{};
+  std::atomic<uint64_t> epoch{};
+};
+
+struct Parse;
+
+// one per thread that reads the published arena
+// lock pins the arena until unlock, a dbc swap in between retires it but never frees it
+// an appending reader's lock passes over a resized arena until it has caught up
+struct ArenaReader {
+  Parse* parse{};
+  uint32_t slot = ARENA_READERS_MAX;
+  bool appends{};
+
+  bool attach(Parse& parse, bool appends = false);
+  void detach();
+  Arena* lock();
+  void unlock();
+};
+
+// a retired arena is freed once every reader has moved past the epoch it was retired in
+struct RetiredArena {
+  Arena* arena{};
+  uint64_t epoch{};
+};
+
 struct Parse {
-  Arena arena{};
+  // built on the side and swapped in whole, readers never see a half loaded arena
+  std::atomic<Arena*> published{};
+  std::atomic<uint64_t> epoch{1};
+  std::array<ArenaReaderSlot, ARENA_READERS_MAX> readers{};
+  std::vector<RetiredArena> retired{};
+  std::mutex retireMutex{};
+  std::mutex loadMutex{};
+  // handed to readers while nothing is loaded so they never see null
+  Arena emptyArena{};
+
+  // buffers are sized from dbc cycle times on load and from measured rates on resize
+  double retention = ARENA_DEFAULT_RETENTION;
+  bool autoResize = true;
+  // storage layout, see arenaConfig, all apply from the next load
+  bool blocked{};
+  bool raw{};
+  bool typed{};
+  // record every load into a new file under sessionPath, the default data dir when empty
+  // a session keeps its layout, drifting rates do not resize it
+  bool persist{};
+  std::string sessionPath{};
+  std::chrono::steady_clock::time_point lastResize{};
+  // older samples are compressed into cold in the background while compact is set, the arena
+  // stays the hot window and every dbc load starts a new history
+  ColdStore cold{};
+  std::atomic<bool> compact{};
+  std::jthread compactor{};
+
   DBCType activeDBC = DBCType::Lonestar;
   std::string activeDBCLabel = "Lonestar";
   std::string activeDBCPath = {};
   void init();
   bool loadDBC(DBCType kind);
   bool loadDBCFile(const std::string& path);
+  bool loadDBCFiles(std::span<const BusFile> files);
+  bool loadView(const DbcView& dbc);
+  bool loadViews(std::span<const BusView> views, const SessionSource& source = {});
+  bool loadArena(std::span<const BusView> views, const arenaConfig& config,
+                 const SessionSource& source);
+  bool openSession(const std::string& path);
+  bool resize(double retentionSeconds);
+  bool resizeIfDrifted();
+  void compactLoop(std::stop_token stoken);
+  void publish(Arena* next);
+  void reclaim();
   void destroy();
 
-  static constexpr uint32_t dbcCount() { return 5; }
+  static constexpr uint32_t dbcCount() { return 6; }
   static const char* dbcName(DBCType kind);
   const char* currentDBCName() const;
 };
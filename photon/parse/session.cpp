@@ -0,0 +1,391 @@
+#include "session.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <span>
+#include <system_error>
+#include <vector>
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "../engine/include.hpp"
+#include "mapped.hpp"
+
+// same locations the dbc cache uses, with data in place of cache
+std::filesystem::path sessionDir() {
+  std::filesystem::path dir{};
+#ifdef _WIN32
+  if (const char* local = std::getenv("LOCALAPPDATA"); local && *local)
+    dir = std::filesystem::path(local) / "Photon" / "sessions";
+#else
+  if (const char* xdg = std::getenv("XDG_DATA_HOME"); xdg && *xdg)
+    dir = std::filesystem::path(xdg) / "Photon" / "sessions";
+  else if (const char* home = std::getenv("HOME"); home && *home)
+    dir = std::filesystem::path(home) / ".local" / "share" / "Photon" / "sessions";
+#endif
+  return dir;
+}
+
+std::filesystem::path newSessionPath(const std::filesystem::path& dir) {
+  if (dir.empty()) return {};
+  std::error_code error{};
+  std::filesystem::create_directories(dir, error);
+  char stamp[32];
+  const std::time_t now = std::time(nullptr);
+  std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", std::localtime(&now));
+  for (uint32_t n = 0; n < 100; n++) {
+    char name[64];
+    if (n)
+      std::snprintf(name, sizeof(name), "session-%s-%u.photon", stamp, n);
+    else
+      std::snprintf(name, sizeof(name), "session-%s.photon", stamp);
+    if (!std::filesystem::exists(dir / name, error)) return dir / name;
+  }
+  return {};
+}
+
+uint64_t unixMs() {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                   std::chrono::system_clock::now().time_since_epoch())
+                                   .count());
+}
+
+// the trailer starts on the page after the buffers so it can be mapped on its own
+constexpr size_t trailerOffsetFor(size_t arenaSize) {
+  return SESSION_DATA_OFFSET + (arenaSize + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+}
+
+// the layout is stored flat, fixed width fields in order, see writeLayout
+struct LayoutWriter {
+  std::vector<uint8_t> bytes{};
+
+  template <typename T>
+  void put(T value) {
+    const size_t at = bytes.size();
+    bytes.resize(at + sizeof(T));
+    std::memcpy(bytes.data() + at, &value, sizeof(T));
+  }
+  void putColumns(const std::vector<ColumnType>& columns) {
+    put(static_cast<uint32_t>(columns.size()));
+    for (const ColumnType column : columns) put(column);
+  }
+};
+
+struct LayoutReader {
+  std::span<const uint8_t> bytes{};
+  size_t at{};
+  bool ok = true;
+
+  template <typename T>
+  T get() {
+    T value{};
+    if (!ok || bytes.size() - at < sizeof(T)) {
+      ok = false;
+      return value;
+    }
+    std::memcpy(&value, bytes.data() + at, sizeof(T));
+    at += sizeof(T);
+    return value;
+  }
+  // counts are checked against the bytes left so a corrupt trailer cannot ask for gigabytes
+  uint32_t count(size_t each) {
+    const auto n = get<uint32_t>();
+    if (ok && n > (bytes.size() - at) / each) ok = false;
+    return ok ? n : 0;
+  }
+  std::vector<ColumnType> getColumns() {
+    std::vector<ColumnType> columns(count(sizeof(ColumnType)));
+    for (ColumnType& column : columns) column = get<ColumnType>();
+    return columns;
+  }
+};
+
+// the config init laid this arena out from, the rates its buffers were sized with rather than
+// measured ones, so init lays a reopened file out again byte for byte
+std::vector<uint8_t> writeLayout(const Arena& arena) {
+  arenaConfig config = arena.layout();
+  LayoutWriter out{};
+  out.put(static_cast<uint8_t>(arena.blocked));
+  out.put(static_cast<uint8_t>(arena.raw));
+  out.put(static_cast<uint8_t>(arena.typed));
+  out.put(arena.retention);
+  out.put(static_cast<uint64_t>(arena.arenaSize));
+  out.put(static_cast<uint32_t>(config.validIds.size()));
+  for (size_t i = 0; i < config.validIds.size(); i++) {
+    const Message* msg = arena.message(config.validIds[i]);
+    const MuxConfig& mux = config.mux[i];
+    out.put(config.validIds[i]);
+    out.put(config.signalCounts[i]);
+    out.put(msg ? msg->rate : config.rates[i]);
+    out.putColumns(config.columns[i]);
+    out.put(mux.multiplexor);
+    out.put(static_cast<uint8_t>(mux.tapped));
+    out.put(static_cast<uint32_t>(mux.values.size()));
+    for (size_t g = 0; g < mux.values.size(); g++) {
+      out.put(mux.values[g]);
+      out.put(mux.signalCounts[g]);
+      out.putColumns(mux.columns[g]);
+    }
+  }
+  return std::move(out.bytes);
+}
+
+bool readLayout(std::span<const uint8_t> bytes, arenaConfig& config) {
+  LayoutReader in{bytes};
+  config = {};
+  config.ring = true;
+  config.blocked = in.get<uint8_t>();
+  config.raw = in.get<uint8_t>();
+  config.typed = in.get<uint8_t>();
+  config.retention = in.get<double>();
+  config.arenaSize = in.get<uint64_t>();
+  // an id, a signal count, a rate and three counts at the least
+  const uint32_t messages = in.count(29);
+  for (uint32_t i = 0; i < messages && in.ok; i++) {
+    config.validIds.push_back(in.get<uint32_t>());
+    config.signalCounts.push_back(in.get<uint32_t>());
+    config.rates.push_back(in.get<double>());
+    config.columns.push_back(in.getColumns());
+    MuxConfig mux{};
+    mux.multiplexor = in.get<uint32_t>();
+    mux.tapped = in.get<uint8_t>();
+    const uint32_t groups = in.count(12);
+    for (uint32_t g = 0; g < groups && in.ok; g++) {
+      mux.values.push_back(in.get<uint32_t>());
+      mux.signalCounts.push_back(in.get<uint32_t>());
+      mux.columns.push_back(in.getColumns());
+    }
+    config.mux.push_back(std::move(mux));
+  }
+  return in.ok && in.at == bytes.size();
+}
+
+int openSessionFile(const std::string& path, bool reopen, size_t dataBytes) {
+#ifdef __linux__
+  const int flags = O_RDWR | O_CLOEXEC | (reopen ? 0 : O_CREAT | O_TRUNC);
+  const int fd = open(path.c_str(), flags, 0644);
+  if (fd < 0) {
+    logs("could not open session " << path);
+    return -1;
+  }
+  const auto bytes = static_cast<off_t>(SESSION_DATA_OFFSET + dataBytes);
+  struct stat info{};
+  const bool sized =
+      reopen ? fstat(fd, &info) == 0 && info.st_size >= bytes : ftruncate(fd, bytes) == 0;
+  if (!sized) {
+    logs("session " << path << " is " << (reopen ? "truncated" : "out of space"));
+    close(fd);
+    return -1;
+  }
+  return fd;
+#else
+  (void)path;
+  (void)reopen;
+  (void)dataBytes;
+  return -1;
+#endif
+}
+
+// a copy of the header and the layout it describes, every offset checked against the file
+bool readSession(const std::string& path, SessionHeader& header, arenaConfig& config) {
+  MappedFile file{};
+  if (!file.open(path)) return false;
+  bool ok = file.size >= SESSION_DATA_OFFSET;
+  if (ok) std::memcpy(&header, file.data, sizeof(header));
+  ok = ok && header.magic == SESSION_MAGIC && header.version == SESSION_VERSION &&
+       header.source.fileCount <= CAN_BUS_MAX &&
+       header.trailerOffset == trailerOffsetFor(header.arenaSize);
+  const size_t tableBytes = static_cast<size_t>(header.messageCount) * sizeof(SessionMessage);
+  ok = ok && header.trailerOffset <= file.size &&
+       tableBytes + header.layoutBytes <= file.size - header.trailerOffset;
+  if (ok) {
+    const auto* layout =
+        reinterpret_cast<const uint8_t*>(file.data) + header.trailerOffset + tableBytes;
+    ok = readLayout({layout, header.layoutBytes}, config) && config.arenaSize == header.arenaSize;
+  }
+  file.close();
+  if (!ok) return false;
+  for (SessionFile& source : header.source.files) source.path[SESSION_PATH_MAX - 1] = '\0';
+  config.session = path;
+  config.reopen = true;
+  return true;
+}
+
+#ifdef __linux__
+bool mapSession(Arena& arena, size_t trailerOffset, size_t trailerBytes) {
+  void* header = mmap(nullptr, SESSION_DATA_OFFSET, PROT_READ | PROT_WRITE, MAP_SHARED,
+                      arena.ringFd, 0);
+  if (header == MAP_FAILED) return false;
+  void* trailer = mmap(nullptr, trailerBytes, PROT_READ | PROT_WRITE, MAP_SHARED, arena.ringFd,
+                       static_cast<off_t>(trailerOffset));
+  if (trailer == MAP_FAILED) {
+    munmap(header, SESSION_DATA_OFFSET);
+    return false;
+  }
+  arena.sessionHeader = static_cast<SessionHeader*>(header);
+  arena.sessionTrailer = static_cast<uint8_t*>(trailer);
+  arena.sessionTrailerBytes = trailerBytes;
+  return true;
+}
+#endif
+
+// writes the trailer and header of a session arena init just created, then checkpoints it
+// a file that cannot be completed is unlinked, the arena keeps its buffers either way
+bool createSession(Arena& arena, uint64_t dbcHash, const SessionSource& source) {
+#ifdef __linux__
+  if (arena.session.empty() || arena.sessionHeader) return false;
+  const std::vector<uint8_t> layout = writeLayout(arena);
+  const size_t trailerOffset = trailerOffsetFor(arena.arenaSize);
+  const size_t tableBytes = static_cast<size_t>(arena.storedMessages) * sizeof(SessionMessage);
+  const size_t trailerBytes = tableBytes + layout.size();
+  if (ftruncate(arena.ringFd, static_cast<off_t>(trailerOffset + trailerBytes)) != 0 ||
+      !mapSession(arena, trailerOffset, trailerBytes)) {
+    unlink(arena.session.c_str());
+    arena.session.clear();
+    return false;
+  }
+
+  auto* table = reinterpret_cast<SessionMessage*>(arena.sessionTrailer);
+  for (uint32_t m = 0; m < arena.storedMessages; m++)
+    table[m] = {arena.messageStore[m].id, arena.messageStore[m].muxValue, 0, 0};
+  std::memcpy(arena.sessionTrailer + tableBytes, layout.data(), layout.size());
+  *arena.sessionHeader = {
+      .magic = SESSION_MAGIC,
+      .version = SESSION_VERSION,
+      .dbcHash = dbcHash,
+      .source = source,
+      .arenaSize = arena.arenaSize,
+      .trailerOffset = trailerOffset,
+      .messageCount = arena.storedMessages,
+      .layoutBytes = static_cast<uint32_t>(layout.size()),
+      .created = unixMs(),
+  };
+  checkpointSession(arena, false);
+  logs("recording session " << arena.session);
+  return true;
+#else
+  (void)arena;
+  (void)dbcHash;
+  (void)source;
+  return false;
+#endif
+}
+
+// maps the header and trailer of a reopened session and takes over every message's frames
+bool restoreSession(Arena& arena) {
+#ifdef __linux__
+  if (arena.session.empty() || arena.sessionHeader) return false;
+  SessionHeader header{};
+  if (pread(arena.ringFd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)))
+    return false;
+  const size_t tableBytes = static_cast<size_t>(header.messageCount) * sizeof(SessionMessage);
+  if (header.magic != SESSION_MAGIC || header.arenaSize != arena.arenaSize ||
+      header.messageCount != arena.storedMessages ||
+      header.trailerOffset != trailerOffsetFor(arena.arenaSize))
+    return false;
+  if (!mapSession(arena, header.trailerOffset, tableBytes + header.layoutBytes)) return false;
+
+  const auto* table = reinterpret_cast<const SessionMessage*>(arena.sessionTrailer);
+  for (uint32_t m = 0; m < arena.storedMessages; m++) {
+    const Message& msg = arena.messageStore[m];
+    if (table[m].id == msg.id && table[m].muxValue == msg.muxValue) continue;
+    closeSession(arena);
+    return false;
+  }
+  uint64_t frames = 0;
+  for (uint32_t m = 0; m < arena.storedMessages; m++) {
+    Message& msg = arena.messageStore[m];
+    arena.restore(msg, table[m].head, table[m].tail);
+    frames += (msg.counters.head.load() - msg.counters.tail.load()) / sizeof(double);
+  }
+  logs("reopened session " << arena.session << " with " << frames << " frames"
+                           << (header.clean ? "" : ", it was not closed cleanly"));
+  checkpointSession(arena, false);
+  return true;
+#else
+  (void)arena;
+  return false;
+#endif
+}
+
+// heads are read before the buffers are flushed so none points past what reached the file,
+// tails after so none points at a slot a ring overwrote in between, the header goes last
+// the flush needs only a second fd of the file, so the arena can be let go while it runs
+bool beginCheckpoint(const Arena& arena, SessionCheckpoint& checkpoint) {
+#ifdef __linux__
+  if (!arena.sessionHeader || !arena.sessionTrailer) return false;
+  checkpoint.fd = fcntl(arena.ringFd, F_DUPFD_CLOEXEC, 0);
+  if (checkpoint.fd < 0) return false;
+  checkpoint.generation = arena.generation;
+  checkpoint.heads.resize(arena.storedMessages);
+  for (uint32_t m = 0; m < arena.storedMessages; m++)
+    checkpoint.heads[m] = arena.messageStore[m].counters.head.load(std::memory_order_acquire);
+  return true;
+#else
+  (void)arena;
+  (void)checkpoint;
+  return false;
+#endif
+}
+
+// writes back only the dirty pages of the file, whichever view of the ring dirtied them
+void flushCheckpoint(SessionCheckpoint& checkpoint) {
+#ifdef __linux__
+  if (checkpoint.fd < 0) return;
+  fdatasync(checkpoint.fd);
+  close(checkpoint.fd);
+  checkpoint.fd = -1;
+#else
+  (void)checkpoint;
+#endif
+}
+
+// a checkpoint begun on an arena that has since been replaced is dropped
+void endCheckpoint(Arena& arena, const SessionCheckpoint& checkpoint, bool clean) {
+#ifdef __linux__
+  if (!arena.sessionHeader || !arena.sessionTrailer || arena.generation != checkpoint.generation)
+    return;
+  auto* table = reinterpret_cast<SessionMessage*>(arena.sessionTrailer);
+  for (uint32_t m = 0; m < arena.storedMessages; m++) {
+    const uint64_t tail = arena.messageStore[m].counters.tail.load(std::memory_order_acquire);
+    table[m].head = checkpoint.heads[m];
+    table[m].tail = std::min(tail, checkpoint.heads[m]);
+  }
+  msync(arena.sessionTrailer, arena.sessionTrailerBytes, MS_SYNC);
+  SessionHeader& header = *arena.sessionHeader;
+  header.checkpointed = unixMs();
+  header.checkpoints++;
+  header.clean = clean;
+  msync(arena.sessionHeader, SESSION_DATA_OFFSET, MS_SYNC);
+#else
+  (void)arena;
+  (void)checkpoint;
+  (void)clean;
+#endif
+}
+
+void checkpointSession(Arena& arena, bool clean) {
+  SessionCheckpoint checkpoint{};
+  if (!beginCheckpoint(arena, checkpoint)) return;
+  flushCheckpoint(checkpoint);
+  endCheckpoint(arena, checkpoint, clean);
+}
+
+// a last checkpoint marked clean, the buffers stay mapped until the arena is destroyed
+void closeSession(Arena& arena) {
+#ifdef __linux__
+  if (!arena.sessionHeader) return;
+  checkpointSession(arena, true);
+  munmap(arena.sessionHeader, SESSION_DATA_OFFSET);
+  munmap(arena.sessionTrailer, arena.sessionTrailerBytes);
+#endif
+  arena.sessionHeader = nullptr;
+  arena.sessionTrailer = nullptr;
+  arena.sessionTrailerBytes = 0;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "arena.hpp"
+
+// a session file is a ring arena's memfd made durable
+// page 0 is a SessionHeader, the buffers follow exactly as the ring maps them, and the trailer
+// after them holds one SessionMessage per stored message and then the layout init was given
+constexpr uint32_t SESSION_MAGIC = 0x53534850;  // "PHSS"
+constexpr uint32_t SESSION_VERSION = 1;
+constexpr size_t SESSION_DATA_OFFSET = PAGE_SIZE;
+constexpr uint32_t SESSION_PATH_MAX = 240;
+// how often the counters are written back, appends after the last checkpoint are recovered
+// on reopen for as long as their times keep going forward
+constexpr std::chrono::seconds SESSION_CHECKPOINT_INTERVAL{2};
+
+// the dbc one bus was loaded from, path is empty for a built in dbc
+struct SessionFile {
+  uint32_t bus{};
+  char path[SESSION_PATH_MAX]{};
+};
+
+// what a session was recorded against, enough to load the same dbcs again
+// kind is a DBCType, files are only used for DBCType::File
+struct SessionSource {
+  uint32_t kind{};
+  uint32_t fileCount{};
+  SessionFile files[CAN_BUS_MAX]{};
+};
+
+struct SessionHeader {
+  uint32_t magic{};
+  uint32_t version{};
+  // see hashViews, a reopen refuses dbcs that describe the frames differently
+  uint64_t dbcHash{};
+  SessionSource source{};
+  uint64_t arenaSize{};
+  uint64_t trailerOffset{};
+  uint32_t messageCount{};
+  uint32_t layoutBytes{};
+  // unix ms
+  uint64_t created{};
+  uint64_t checkpointed{};
+  uint64_t checkpoints{};
+  // set by the checkpoint of a clean close, a crashed session reopens with it clear
+  uint32_t clean{};
+  uint32_t reserved{};
+};
+
+static_assert(sizeof(SessionHeader) <= SESSION_DATA_OFFSET);
+
+// counters of one message or mux group as of the last checkpoint, in message store order
+struct SessionMessage {
+  uint32_t id{};
+  uint32_t muxValue{};
+  uint64_t head{};
+  uint64_t tail{};
+};
+
+// the heads a checkpoint records, taken before the buffers are flushed, see beginCheckpoint
+struct SessionCheckpoint {
+  uint64_t generation{};
+  int fd = -1;
+  std::vector<uint64_t> heads{};
+};
+
+// <data>/Photon/sessions, a new file is named after the local time it was started
+std::filesystem::path sessionDir();
+std::filesystem::path newSessionPath(const std::filesystem::path& dir);
+
+// the ring fd of a session arena, created at dataBytes or reopened if it holds at least that
+int openSessionFile(const std::string& path, bool reopen, size_t dataBytes);
+bool readSession(const std::string& path, SessionHeader& header, arenaConfig& config);
+bool createSession(Arena& arena, uint64_t dbcHash, const SessionSource& source);
+bool restoreSession(Arena& arena);
+bool beginCheckpoint(const Arena& arena, SessionCheckpoint& checkpoint);
+void flushCheckpoint(SessionCheckpoint& checkpoint);
+void endCheckpoint(Arena& arena, const SessionCheckpoint& checkpoint, bool clean);
+void checkpointSession(Arena& arena, bool clean);
+void closeSession(Arena& arena);